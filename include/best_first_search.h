@@ -0,0 +1,73 @@
+/**
+ * best_first_search.h
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * Contains BestFirstSearch, which searches a move class for a target by always
+ * expanding the matrix which looks closest to a representative, rather than
+ * the matrix found first.
+ *
+ * In exact mode this is an A* search using RepDistance::lower_bound, which
+ * never overestimates and changes by at most one per step, so the first target
+ * found is at the same depth a breadth first search would find. Otherwise the
+ * search is greedy, guided by RepDistance::estimate, and the result is only
+ * known to be minimal if it matches the lower bound for the input.
+ */
+#pragma once
+
+#include "move_search.h"
+#include "progress.h"
+#include "rep_distance.h"
+#include "result.h"
+#include "target_set.h"
+
+namespace qvmove {
+class BestFirstSearch {
+	private:
+		typedef cluster::EquivQuiverMatrix Matrix;
+		typedef std::shared_ptr<Matrix> MatrixPtr;
+		typedef std::shared_ptr<cluster::MMIMove> MovePtr;
+		typedef MoveSearch::Depth Depth;
+		typedef std::uint32_t Index;
+	public:
+		BestFirstSearch(const std::vector<MovePtr>& moves,
+				const TargetSet& targets, const RepDistance& distance, bool exact);
+		/** Search the move class of init for a target. */
+		Result run(const MatrixPtr& init) const;
+		/** Report the size of the search to progress. */
+		void progress(Progress* progress);
+	private:
+		struct Node {
+			MatrixPtr matrix_;
+			Depth depth_;
+			bool expanded_;
+		};
+		/** Queue entry, ordered by priority_ then tie_ then index_. */
+		struct Entry {
+			int priority_;
+			int tie_;
+			Index index_;
+			bool operator>(const Entry& other) const;
+		};
+
+		MoveExpander expander_;
+		const TargetSet& targets_;
+		const RepDistance& distance_;
+		bool exact_;
+		Progress* progress_;
+
+		Entry entry(const Node& node, Index index) const;
+};
+}
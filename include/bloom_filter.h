@@ -0,0 +1,43 @@
+/**
+ * bloom_filter.h
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * Contains BloomFilter, a fixed size probabilistic set of hash values. It can
+ * wrongly report that a value is in the set, but never that a value is not.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace qvmove {
+class BloomFilter {
+	public:
+		/** Create an empty filter using the given number of bytes. */
+		BloomFilter(std::size_t bytes);
+		/**
+		 * Add the value to the set, returning true if it was possibly already
+		 * there.
+		 */
+		bool insert(std::uint64_t value);
+		/** Remove all values. */
+		void clear();
+	private:
+		/** Number of bits set for each value. */
+		static const int Hashes = 4;
+		std::vector<std::uint64_t> bits_;
+};
+}
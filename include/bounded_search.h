@@ -0,0 +1,93 @@
+/**
+ * bounded_search.h
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * Contains BoundedSearch, which searches a move class for a target without
+ * using more than a fixed amount of memory.
+ *
+ * The search starts as an ordinary breadth first search, with room reserved up
+ * front for as many matrices as fit in half of the memory budget. If that room
+ * fills up, it is dropped and the search continues as an iterative deepening
+ * depth first search from the level it had reached. Each pass of the deepening
+ * search uses a Bloom filter to avoid expanding the same matrix at the same
+ * depth twice, and a second filter records every matrix seen so that the
+ * search stops once a pass finds nothing new. The filters are keyed on the
+ * canonical form of each matrix, and take a quarter of the budget each. The
+ * depth first stack uses the rest, counting every allocation it makes, and
+ * leaves out any neighbours which do not fit. Room for the temporary memory
+ * used to expand a single matrix is set aside from the budget first. False positives in either filter
+ * and neighbours left out can cause matrices to be skipped, so results found
+ * this way are marked as degraded.
+ */
+#pragma once
+
+#include "move_search.h"
+#include "progress.h"
+#include "result.h"
+#include "target_set.h"
+
+namespace qvmove {
+class BloomFilter;
+class BoundedSearch {
+	private:
+		typedef cluster::EquivQuiverMatrix Matrix;
+		typedef std::shared_ptr<Matrix> MatrixPtr;
+		typedef std::shared_ptr<cluster::MMIMove> MovePtr;
+		typedef MoveSearch::Depth Depth;
+	public:
+		/** Use at most budget bytes for each search. */
+		BoundedSearch(const std::vector<MovePtr>& moves, const TargetSet& targets,
+				std::size_t budget);
+		/** Search the move class of init for a target. */
+		Result run(const MatrixPtr& init) const;
+		/** Report the size of the search to progress. */
+		void progress(Progress* progress);
+	private:
+		/** A matrix on the depth first search stack. */
+		struct Frame {
+			Depth depth_;
+			std::vector<std::pair<MatrixPtr, int>> children_;
+			std::size_t next_;
+		};
+
+		const std::vector<MovePtr>& moves_;
+		MoveExpander expander_;
+		const TargetSet& targets_;
+		std::size_t budget_;
+		Progress* progress_;
+
+		/**
+		 * Number of matrices the size of those being searched which are set aside
+		 * from the budget for the temporary memory used while expanding or finding
+		 * the canonical form of a single matrix.
+		 */
+		static const std::size_t Scratch = 16;
+
+		/**
+		 * Iterative deepening search, starting with the given depth limit and using
+		 * at most bytes.
+		 */
+		Result deepen(const MatrixPtr& init, int start, std::size_t bytes) const;
+		/**
+		 * Depth first search to the given limit, keeping the stack within bytes.
+		 * Returns true and sets result if a target is found, and sets grew if any
+		 * matrix not in seen was found.
+		 */
+		bool limited(const MatrixPtr& init, int limit, std::size_t bytes,
+				BloomFilter& seen, BloomFilter& visited, bool& grew,
+				Result& result) const;
+};
+}
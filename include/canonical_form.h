@@ -0,0 +1,51 @@
+/**
+ * canonical_form.h
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * Contains CanonicalForm, which encodes a quiver matrix as a short string of
+ * bytes which is the same for all permutations of the matrix, so that
+ * equivalent matrices can be compared and sorted as plain strings.
+ *
+ * The key is the size of the matrix followed by the entries above the
+ * diagonal, column by column, for the ordering of the vertices which makes
+ * these entries lexicographically smallest. Only orderings which sort the
+ * vertices by their multiset of row entries are tried, and at each position
+ * only the vertices giving the smallest next column are followed, which keeps
+ * the search small.
+ */
+#pragma once
+
+#include <string>
+
+#include "qv/equiv_quiver_matrix.h"
+
+namespace qvmove {
+class CanonicalForm {
+	private:
+		typedef cluster::EquivQuiverMatrix Matrix;
+		typedef std::shared_ptr<Matrix> MatrixPtr;
+	public:
+		/** Largest matrix which can be encoded. */
+		static const int MaxSize = 22;
+		/**
+		 * Compute the key of the matrix. Returns an empty string if the matrix is
+		 * too large, or has entries too large to encode.
+		 */
+		static std::string key(const cluster::IntMatrix& m);
+		/** Get a matrix with the given key. */
+		static MatrixPtr matrix(const std::string& key);
+};
+}
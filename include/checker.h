@@ -28,6 +28,15 @@
 #include "qv/equiv_underlying_graph.h"
 #include "qv/move_class_loader.h"
 
+#include "dedupe_cache.h"
+#include "move_search.h"
+#include "progress.h"
+#include "rep_distance.h"
+#include "result.h"
+#include "shared_index.h"
+#include "target_set.h"
+#include "work_pool.h"
+
 namespace qvmove {
 class Checker {
 	private:
@@ -41,10 +50,65 @@ class Checker {
 		typedef std::shared_ptr<Graph> GraphPtr;
 		typedef std::unordered_set<GraphPtr> GraphSet;
 		typedef std::unique_ptr<cluster::MoveClassLoader> LoaderPtr;
+		typedef std::shared_ptr<SharedIndex> IndexPtr;
+		typedef std::unique_ptr<WorkPool> PoolPtr;
 	public:
+		/** Settings which change how the checks are carried out. */
+		struct Options {
+			Options()
+				: paths_(false),
+					threads_(1),
+					best_first_(false),
+					exact_(false),
+					per_move_(0),
+					dedupe_(0),
+					progress_(0),
+					metrics_(),
+					budget_(0) {}
+			/** Output the moves used to reach the representative. */
+			bool paths_;
+			/**
+			 * Number of threads to use. If more than one, the inputs and the move
+			 * classes are searched in parallel. Ignored if paths_ or best_first_ is
+			 * set.
+			 */
+			int threads_;
+			/**
+			 * Search each class by expanding the matrices which look closest to a
+			 * representative first. Ignored if paths_ is set.
+			 */
+			bool best_first_;
+			/** Ensure the best first search still finds the minimal depth. */
+			bool exact_;
+			/**
+			 * Largest change to the numbers of arrows of each weight made by one
+			 * move, see consts::MoveWeightChange.
+			 */
+			int per_move_;
+			/**
+			 * If not zero, each class of equivalent inputs is only searched once,
+			 * with up to this many results kept in memory. Ignored if paths_ is set.
+			 */
+			std::size_t dedupe_;
+			/** Seconds between progress reports on stderr, or 0 for none. */
+			int progress_;
+			/** File to keep up to date with the progress metrics, if not empty. */
+			std::string metrics_;
+			/**
+			 * If not zero, the most memory in bytes to use when searching each
+			 * class. Overrides threads_ and best_first_. Not allowed with paths_,
+			 * as finding a path keeps the whole class in memory.
+			 */
+			std::size_t budget_;
+		};
+		/**
+		 * If index is not null then it is checked for each input before searching
+		 * its move class, and any newly computed results are added to it.
+		 */
 		Checker(InPtr input, OutPtr output,
 				const std::vector<MovePtr>& moves,
-				const MatrixSet& reps, const GraphSet& graphs);
+				const MatrixSet& reps, const GraphSet& graphs,
+				IndexPtr index = IndexPtr(), const Options& options = Options());
 		Checker(Checker& check) = delete;
 		Checker(Checker&& check) = default;
 		void run();
@@ -56,7 +120,39 @@ class Checker {
 		LoaderPtr loader_;
 		const MatrixSet& reps_;
 		const GraphSet& graphs_;
-		GraphPtr tmp_graph_;
+		TargetSet targets_;
+		IndexPtr index_;
+		Options options_;
+		/** Matrices on the path to the last representative found, along with the
+		 * move used to reach each one. Only used if options_.paths_ is set. */
+		std::vector<std::pair<int, MatrixPtr>> path_;
+		PoolPtr pool_;
+		std::unique_ptr<RepDistance> distance_;
+		std::unique_ptr<DedupeCache> cache_;
+		std::unique_ptr<Progress> progress_;
+
+		/** Check all inputs, searching many classes at once using pool_. */
+		void run_parallel();
+
+		/**
+		 * Get the matrix to search from instead of init. Breadth first order
+		 * depends on how the vertices are labelled, so equivalent inputs can reach
+		 * a representative with a different number of moves and sink-source
+		 * mutations. When results are shared through the cache or the index, the
+		 * search starts from the canonical labelling so that all equivalent inputs
+		 * get the same result. Otherwise init itself is searched.
+		 */
+		MatrixPtr relabel(const MatrixPtr& init) const;
+		/** Find the result for init, using the index if available. */
+		Result solve(const MatrixPtr& init);
+		/** Search the move class of init for a representative. */
+		Result search(const MatrixPtr& init);
+		/** Search the move class of init, keeping the path to the representative. */
+		Result search_path(const MatrixPtr& init);
+		/** Search the move class of init, looking at the most promising first. */
+		Result search_best_first(const MatrixPtr& init);
+		/** Write the result for init to the output. */
+		void write(const MatrixPtr& init, const Result& result);
 };
 }
 
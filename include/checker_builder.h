@@ -51,6 +51,42 @@ class CheckerBuilder {
 		 */
 		void reps(const _MatrixSet& reps);
 		void graphs(const _GraphSet& graphs);
+		/**
+		 * Set the file holding the shared index of solved matrices. If this is
+		 * empty, which is the default, then no index is used.
+		 */
+		void index(const std::string& ifile);
+		/**
+		 * Set whether the Checker outputs the moves used to reach each
+		 * representative. By default it does not.
+		 */
+		void paths(bool paths);
+		/**
+		 * Set the number of threads the Checker uses. By default it uses one.
+		 */
+		void threads(int threads);
+		/**
+		 * Set whether the Checker uses a best first search, and whether that
+		 * search must still find the minimal number of moves. By default a breadth
+		 * first search is used.
+		 */
+		void best_first(bool best_first, bool exact);
+		/**
+		 * Set whether the Checker searches only once for each class of equivalent
+		 * inputs, keeping at most limit results in memory before spilling them to
+		 * disk. A limit of zero, the default, turns this off.
+		 */
+		void dedupe(std::size_t limit);
+		/**
+		 * Set how often, in seconds, the Checker reports its progress on stderr,
+		 * and the file it keeps the same metrics in. By default neither is done.
+		 */
+		void progress(int interval, const std::string& metrics);
+		/**
+		 * Set the most memory in bytes the Checker can use to search each class.
+		 * By default, zero, there is no limit.
+		 */
+		void budget(std::size_t bytes);
 		/**
 		 * Generate the Checker
 		 */
@@ -61,6 +97,8 @@ class CheckerBuilder {
 		_MoveVector& moves_;
 		_MatrixSet& reps_;
 		_GraphSet& graphs_;
+		std::string index_;
+		Checker::Options options_;
 
 		struct NullDeleter {
 			void operator()(const void *const) const {}
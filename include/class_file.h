@@ -0,0 +1,131 @@
+/**
+ * class_file.h
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * Contains ClassWriter and ClassReader, which write and read files holding a
+ * sorted set of matrices, each stored as its CanonicalForm key.
+ *
+ * The file starts with a header giving the number of keys and blocks and the
+ * offset of the index. Keys are stored in blocks of BlockSize, each starting
+ * with the number of keys in the block and the first key in full. Every later
+ * key in a block is stored as the length of the prefix it shares with the key
+ * before it followed by the rest of the key. The index at the end of the file
+ * holds the offset and first key of each block, so a single block needs to be
+ * read to find any key.
+ */
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace qvmove {
+namespace class_file {
+/** Number of keys in each block. */
+static const std::size_t BlockSize = 64;
+/** Offset and first key of a block. */
+typedef std::pair<std::uint64_t, std::string> IndexEntry;
+/** Ways of combining the keys of several files. */
+enum class Operation { Union, Intersect, Difference };
+
+struct Header {
+	char magic_[8];
+	std::uint64_t count_;
+	std::uint64_t blocks_;
+	std::uint64_t index_;
+};
+}
+class ClassWriter {
+	public:
+		ClassWriter(const std::string& path);
+		ClassWriter(const ClassWriter&) = delete;
+		ClassWriter& operator=(const ClassWriter&) = delete;
+		/** Calls close() if it has not already been called. */
+		~ClassWriter();
+		/** Check whether the file was opened successfully. */
+		bool is_open() const;
+		/**
+		 * Add a key to the file. Keys must be added in sorted order, and a key
+		 * equal to the one before is ignored.
+		 */
+		void add(const std::string& key);
+		/**
+		 * Write the index and header, after which no more keys can be added.
+		 * Returns false if any write failed.
+		 */
+		bool close();
+		/** Number of keys added so far. */
+		std::uint64_t size() const;
+	private:
+		std::ofstream out_;
+		std::uint64_t count_;
+		std::vector<class_file::IndexEntry> index_;
+		std::vector<std::string> block_;
+		std::string last_;
+		bool closed_;
+
+		/** Write out the keys in block_. */
+		void write_block();
+};
+class ClassReader {
+	public:
+		ClassReader(const std::string& path);
+		/** Check whether the file was opened and its index read successfully. */
+		bool is_open() const;
+		/**
+		 * Check whether reading a block has failed. After this has_next() returns
+		 * false, so keys may have been missed, and contains() may wrongly return
+		 * false.
+		 */
+		bool failed() const;
+		/** Number of keys in the file. */
+		std::uint64_t size() const;
+		/** Check whether there is another key to read. */
+		bool has_next();
+		/** Get the next key in sorted order. */
+		const std::string& next();
+		/**
+		 * Check whether the file contains the key. This does not change the
+		 * position of next().
+		 */
+		bool contains(const std::string& key);
+	private:
+		std::ifstream in_;
+		bool ok_;
+		bool failed_;
+		class_file::Header header_;
+		std::vector<class_file::IndexEntry> index_;
+		/** Keys in the current block of next(). */
+		std::vector<std::string> block_;
+		std::size_t pos_;
+		std::size_t next_block_;
+		/** The block last read by contains(). */
+		std::vector<std::string> lookup_;
+		std::size_t lookup_block_;
+
+		/** Read and decode a block. */
+		bool read_block(std::size_t block, std::vector<std::string>& keys);
+};namespace class_file {
+/**
+ * Merge the files, writing each key which is in the result of the operation to
+ * the writer. The difference keeps the keys of the first file which are in no
+ * other. All files are read once, in step with each other.
+ */
+void merge(const std::vector<ClassReader*>& readers, Operation operation,
+		ClassWriter& writer);
+}
+}
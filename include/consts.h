@@ -19,6 +19,7 @@
  */
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <unordered_set>
@@ -33,6 +34,17 @@ namespace consts {
 extern std::vector<std::shared_ptr<cluster::MMIMove>> Moves;
 extern std::unordered_set<std::shared_ptr<cluster::EquivQuiverMatrix>> Reps;
 extern std::unordered_set<std::shared_ptr<cluster::EquivUnderlyingGraph>> Graphs;
+/**
+ * Largest change any one of the Moves makes to the numbers of arrows of each
+ * weight: the sum over each weight of the difference between the number of
+ * arrows of that weight in the two submatrices of the move.
+ */
+extern int MoveWeightChange;
+/**
+ * Hash of the definitions of the Moves, in order, so that results computed
+ * with different moves can be told apart.
+ */
+extern std::uint64_t MovesKey;
 
 }
 }
@@ -0,0 +1,64 @@
+/**
+ * dedupe_cache.h
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * Contains DedupeCache, which remembers the result computed for each input
+ * matrix so that inputs which are permutations of an earlier input are not
+ * searched again.
+ *
+ * Up to a fixed number of results are held in memory. When that is exceeded
+ * they are moved into SharedIndex tables backed by temporary files, which the
+ * kernel can page out, so memory use stays bounded however many distinct
+ * inputs there are.
+ */
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "qv/equiv_quiver_matrix.h"
+
+#include "result.h"
+#include "shared_index.h"
+
+namespace qvmove {
+class DedupeCache {
+	private:
+		typedef cluster::EquivQuiverMatrix Matrix;
+		typedef std::shared_ptr<Matrix> MatrixPtr;
+		typedef std::unique_ptr<SharedIndex> IndexPtr;
+	public:
+		/** Keep at most limit results in memory. */
+		DedupeCache(std::size_t limit);
+		/**
+		 * Find the result for a matrix equivalent to m. Returns false if there is
+		 * none, in which case result is not changed.
+		 */
+		bool find(const MatrixPtr& m, Result& result) const;
+		/** Remember the result for m. */
+		void insert(const MatrixPtr& m, const Result& result);
+	private:
+		std::size_t limit_;
+		std::unordered_map<MatrixPtr, Result> memory_;
+		/** Spilled results, each table twice the size of the one before. */
+		std::vector<IndexPtr> spilled_;
+
+		/** Move all results in memory into the spill tables. */
+		void spill();
+		/** Add a new spill table with the given capacity. */
+		bool add_table(std::uint64_t capacity);
+};
+}
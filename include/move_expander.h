@@ -0,0 +1,68 @@
+/**
+ * move_expander.h
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * Contains MoveExpander, which computes all the neighbours of a matrix in its
+ * move class: those matrices reached by applying one of the moves, or by
+ * mutating at a sink or source.
+ */
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "qv/equiv_quiver_matrix.h"
+#include "qv/mmi_move.h"
+
+namespace qvmove {
+class MoveExpander {
+	public:
+		typedef cluster::EquivQuiverMatrix Matrix;
+		typedef std::shared_ptr<Matrix> MatrixPtr;
+		typedef std::shared_ptr<cluster::MMIMove> MovePtr;
+		/**
+		 * Called with each neighbour and the index of the move used to reach it in
+		 * the vector of moves, or SinkSource.
+		 */
+		typedef std::function<void(const MatrixPtr&, int)> Callback;
+		/** Move index used for neighbours reached by a sink-source mutation. */
+		static const int SinkSource = -1;
+
+		MoveExpander(const std::vector<MovePtr>& moves);
+		/**
+		 * Call f on every neighbour of m. The same neighbour may be given more than
+		 * once if it can be reached in more than one way.
+		 */
+		void operator()(const Matrix& m, const Callback& f) const;
+		/**
+		 * Check whether vertex k of m is a sink or a source.
+		 */
+		static bool is_sink_source(const Matrix& m, int k);
+		/**
+		 * Bytes taken from the heap by each neighbour of a matrix with the given
+		 * number of rows, including the overhead of malloc.
+		 */
+		static std::size_t matrix_memory(int size);
+		/**
+		 * Bytes taken from the heap by a single allocation of the given size. Each
+		 * block has a header and is rounded up to 16 bytes.
+		 */
+		static std::size_t allocated(std::size_t bytes);
+	private:
+		const std::vector<MovePtr>& moves_;
+};
+}
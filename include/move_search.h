@@ -0,0 +1,124 @@
+/**
+ * move_search.h
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * Contains MoveSearch, a breadth first search through a move class which can
+ * be used in place of cluster::MoveClassLoader.
+ *
+ * Every matrix found is given an index, which is its position in the order the
+ * matrices are returned by next(). The search can report each edge of the
+ * class, in terms of these indices, as it is discovered.
+ */
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+
+#include "move_expander.h"
+
+namespace qvmove {
+class MoveSearch {
+	public:
+		typedef cluster::EquivQuiverMatrix Matrix;
+		typedef std::shared_ptr<Matrix> MatrixPtr;
+		typedef std::shared_ptr<cluster::MMIMove> MovePtr;
+		typedef std::uint32_t Index;
+		/** Number of moves and sink-source mutations used to reach a matrix. */
+		struct Depth {
+			Depth()
+				: moves_(0),
+					sinksource_(0) {}
+			Depth(int moves, int sinksource)
+				: moves_(moves),
+					sinksource_(sinksource) {}
+			int moves_;
+			int sinksource_;
+		};
+		/**
+		 * Edge from the matrix parent_ to child_, using the move with index move_
+		 * or MoveExpander::SinkSource.
+		 */
+		struct Edge {
+			Index parent_;
+			Index child_;
+			int move_;
+		};
+		typedef std::function<void(const Edge&)> EdgeListener;
+
+		MoveSearch(const MatrixPtr& initial, const std::vector<MovePtr>& moves);
+		/** Check whether there are more matrices in the class. */
+		bool has_next() const;
+		/** Get the next matrix in the class. */
+		MatrixPtr next();
+		/** Depth of the last matrix returned by next(). */
+		Depth depth() const;
+		/** Index of the last matrix returned by next(). */
+		Index index() const;
+		/** Number of matrices found so far. */
+		std::size_t size() const;
+		/** Number of matrices found but not yet returned. */
+		std::size_t remaining() const;
+		/**
+		 * Number of bytes taken from the heap to store the matrices found,
+		 * including the space reserved for more.
+		 */
+		std::size_t memory() const;
+		/**
+		 * Reserve room for as many matrices as fit in the given number of bytes,
+		 * and find no more than that. Any further matrices are dropped, along with
+		 * the edges to them, and full() becomes true. Because the room is reserved
+		 * up front, memory() never grows past bytes.
+		 */
+		void limit_memory(std::size_t bytes);
+		/** Check whether any matrices were dropped by limit_memory(). */
+		bool full() const;
+		/**
+		 * Set a function to call on every edge found, including those leading to
+		 * matrices which have already been seen.
+		 */
+		void edge_listener(const EdgeListener& listener);
+		/** Get the matrix with the given index. */
+		const MatrixPtr& matrix(Index index) const;
+		/**
+		 * Get the edges of a shortest path from the initial matrix to the matrix
+		 * with the given index, in the order they are followed.
+		 */
+		std::vector<Edge> path(Index index) const;
+	private:
+		/* Only the index of the parent is kept, not a pointer to it, so tracking
+		 * the path to each matrix costs 8 bytes per matrix. */
+		struct Node {
+			MatrixPtr matrix_;
+			Depth depth_;
+			Index parent_;
+			int move_;
+		};
+
+		MoveExpander expander_;
+		/** All matrices found so far, in the order they were found. Those after
+		 * next_ have not yet been returned, so this doubles as the queue. */
+		std::vector<Node> nodes_;
+		std::unordered_map<MatrixPtr, Index> seen_;
+		Index next_;
+		EdgeListener listener_;
+		/** Bytes taken by each matrix and its node in seen_, on top of its Node
+		 * and bucket. */
+		std::size_t matrix_bytes_;
+		/** Most matrices to find. */
+		std::size_t limit_;
+		bool full_;
+};
+}
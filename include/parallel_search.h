@@ -0,0 +1,159 @@
+/**
+ * parallel_search.h
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * Contains ParallelSearch, which searches a move class using all the threads
+ * of a WorkPool.
+ *
+ * The search runs level by level. The set of matrices seen so far is split by
+ * hash into shards, and each shard is owned by one NUMA node of the pool, as is
+ * the part of the frontier whose matrices hash to that shard. The frontier is
+ * cut into chunks, and each level is computed a batch of chunks at a time, so
+ * only the neighbours of one batch are held before they are merged. Each batch
+ * takes two rounds of tasks:
+ *
+ *  - each chunk is expanded by a task, preferably on the node owning it, which
+ *    sorts the neighbours found by shard;
+ *  - each shard then has a task pinned to its own node which adds the new
+ *    neighbours to the shard and to the shard's part of the next frontier.
+ *
+ * Each matrix remembers its position in its level in breadth first order, and
+ * new matrices are ordered by the position of their parent and then the order
+ * they were found in. When a matrix is found more than once in a level only
+ * the first in this order is kept, and run() reports the first target in this
+ * order, so results always match those of MoveSearch.
+ *
+ * Only one task touches a shard at a time, so the shards need no locks. On
+ * machines with more than one node, a new matrix is copied by the merge task
+ * before it is kept, so that the shard's matrices, set and frontier are all
+ * allocated on its own node. Expansion tasks can still be stolen by other
+ * nodes, and then read the frontier remotely. A single large class is spread
+ * across every worker while other tasks in the pool are still free to run.
+ */
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "move_search.h"
+#include "progress.h"
+#include "result.h"
+#include "target_set.h"
+#include "work_pool.h"
+
+namespace qvmove {
+class ParallelSearch {
+	private:
+		typedef cluster::EquivQuiverMatrix Matrix;
+		typedef std::shared_ptr<Matrix> MatrixPtr;
+		typedef std::shared_ptr<cluster::MMIMove> MovePtr;
+		typedef MoveSearch::Depth Depth;
+	public:
+		/**
+		 * Called with each matrix in the class in turn. Returning false stops the
+		 * enumeration.
+		 */
+		typedef std::function<bool(const MatrixPtr&)> Visitor;
+		/** Number of matrices expanded by each task. */
+		static const std::size_t ChunkSize = 64;
+		/** Number of shards the set of seen matrices is split into. */
+		static const std::size_t Shards = 64;
+		/** Number of chunks expanded before their neighbours are merged. */
+		static const std::size_t BatchSize = 1024;
+
+		ParallelSearch(WorkPool& pool, const std::vector<MovePtr>& moves,
+				const TargetSet& targets);
+		/**
+		 * Search the move class of init for a target. Can be called from many
+		 * threads at once, including from tasks running in the pool.
+		 */
+		Result run(const MatrixPtr& init) const;
+		/**
+		 * Call visit on every matrix in the move class of init, level by level.
+		 * The visitor is always called from the calling thread.
+		 */
+		void enumerate(const MatrixPtr& init, const Visitor& visit) const;
+		/** Report the size of each level to progress. */
+		void progress(Progress* progress);
+	private:
+		struct Node {
+			MatrixPtr matrix_;
+			Depth depth_;
+			/**
+			 * Position of the matrix in its level in breadth first order. For a
+			 * matrix just found this is the position of its parent, and child_ is
+			 * its position among the neighbours of the parent.
+			 */
+			std::uint64_t order_;
+			std::uint32_t child_;
+		};
+		typedef std::vector<Node> Frontier;
+		/** Neighbours found by one expansion task, sorted by shard. */
+		typedef std::vector<Frontier> Found;
+		/** Position in a shard's next frontier of each matrix found in the level. */
+		typedef std::unordered_map<MatrixPtr, std::size_t> Level;
+		/** State of a search, the current level stored by shard. */
+		struct State {
+			State()
+				: seen_(Shards),
+					frontier_(Shards) {}
+			std::vector<std::unordered_set<MatrixPtr>> seen_;
+			std::vector<Frontier> frontier_;
+			bool empty() const;
+			std::size_t frontier_size() const;
+			std::size_t seen_size() const;
+		};
+		/** First target found in the current level. */
+		struct Best {
+			Best()
+				: mutex_(),
+					result_(),
+					node_() {}
+			void offer(const Node& node);
+			std::mutex mutex_;
+			Result result_;
+			Node node_;
+		};
+
+		WorkPool& pool_;
+		MoveExpander expander_;
+		const TargetSet& targets_;
+		Progress* progress_;
+
+		/** Start a search from init. */
+		void start(const MatrixPtr& init, State& state) const;
+		/**
+		 * Replace the frontier with the next level. If best is not null then each
+		 * new matrix is checked against the targets.
+		 */
+		void step(State& state, Best* best) const;
+		void expand(const Node* begin, const Node* end, Found& found) const;
+		void merge(std::size_t shard, std::vector<Found>& found, State& state,
+				Level& level, Frontier& next) const;
+		/**
+		 * Sort a shard's part of the finished next level in breadth first order,
+		 * and offer its first target to best if not null.
+		 */
+		void finish(Frontier& next, Best* best) const;
+		/** Number the new frontier in breadth first order. */
+		static void renumber(std::vector<Frontier>& frontier);
+		/** Check whether a comes before b in breadth first order. */
+		static bool before(const Node& a, const Node& b);
+		/** Node of the pool owning the shard. */
+		int owner(std::size_t shard) const;
+};
+}
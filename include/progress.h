@@ -0,0 +1,73 @@
+/**
+ * progress.h
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * Contains Progress, which collects counters from a long running job and
+ * periodically reports them from a background thread.
+ *
+ * Each report is written as a single line to stderr, and optionally to a
+ * metrics file in the Prometheus text format. The metrics file is replaced
+ * atomically, so it can be read at any time by a job scheduler.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace qvmove {
+class Progress {
+	public:
+		/**
+		 * Report every interval seconds. If interval is zero nothing is written to
+		 * stderr, and if metrics is empty no metrics file is written. The name is
+		 * used to prefix every report and metric.
+		 */
+		Progress(const std::string& name, int interval, const std::string& metrics);
+		Progress(const Progress&) = delete;
+		Progress& operator=(const Progress&) = delete;
+		/** Stop reporting, writing one final report. */
+		~Progress();
+		/** Note that an input has been completed. */
+		void input_done();
+		/** Note the current size of the frontier and visited set of a search. */
+		void search(std::size_t frontier, std::size_t visited);
+	private:
+		typedef std::chrono::steady_clock Clock;
+
+		std::string name_;
+		std::chrono::seconds interval_;
+		bool stderr_;
+		std::string metrics_;
+		Clock::time_point start_;
+		std::atomic<std::uint64_t> inputs_;
+		std::atomic<std::uint64_t> frontier_;
+		std::atomic<std::uint64_t> visited_;
+		std::mutex mutex_;
+		std::condition_variable wake_;
+		bool stop_;
+		std::thread thread_;
+
+		void work();
+		void report();
+		/** Resident set size of this process in bytes, or 0 if unknown. */
+		static std::uint64_t rss();
+};
+}
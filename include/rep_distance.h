@@ -0,0 +1,72 @@
+/**
+ * rep_distance.h
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * Contains RepDistance, which cheaply estimates how far a matrix is from the
+ * nearest class representative of the same size by comparing simple
+ * invariants: the number of arrows of each weight and the degree sequence.
+ */
+#pragma once
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "qv/equiv_quiver_matrix.h"
+
+namespace qvmove {
+class RepDistance {
+	private:
+		typedef cluster::EquivQuiverMatrix Matrix;
+		typedef std::shared_ptr<Matrix> MatrixPtr;
+		typedef std::unordered_set<MatrixPtr> MatrixSet;
+	public:
+		/**
+		 * per_move is the largest change to the numbers of arrows of each weight
+		 * made by any move, see consts::MoveWeightChange.
+		 */
+		RepDistance(const MatrixSet& reps, int per_move);
+		/**
+		 * A lower bound on the number of steps needed to reach any representative
+		 * from m. Sink-source mutations do not change the invariants, and a single
+		 * move can only change the arrows between the vertices it acts on, which
+		 * bounds how much the arrow weight counts can change in one step.
+		 */
+		int lower_bound(const Matrix& m) const;
+		/**
+		 * An estimate of how far m is from the nearest representative. This is
+		 * usually a better guide than lower_bound, but may overestimate.
+		 */
+		int estimate(const Matrix& m) const;
+	private:
+		/** Arrows of weight at least this are counted together. */
+		static const int MaxWeight = 4;
+		struct Invariants {
+			/** weights_[w] is the number of arrows of weight w. */
+			std::vector<int> weights_;
+			/** Sorted numbers of neighbours of each vertex. */
+			std::vector<int> degrees_;
+		};
+
+		std::unordered_map<int, std::vector<Invariants>> reps_;
+		/** Largest change in weight counts which can be made by one move. */
+		int per_move_;
+
+		static Invariants invariants(const Matrix& m);
+		static int weight_diff(const Invariants& a, const Invariants& b);
+		static int degree_diff(const Invariants& a, const Invariants& b);
+};
+}
@@ -0,0 +1,61 @@
+/**
+ * result.h
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * The outcome of searching the move class of a single input matrix.
+ */
+#pragma once
+
+namespace qvmove {
+struct Result {
+	/** Result for a matrix which could not be moved to any representative. */
+	Result()
+		: found_(false),
+			moves_(0),
+			sinksource_(0),
+			minimal_(true),
+			degraded_(false),
+			first_(true) {}
+	/** Result for a matrix which reached a representative. */
+	Result(int moves, int sinksource)
+		: found_(true),
+			moves_(moves),
+			sinksource_(sinksource),
+			minimal_(true),
+			degraded_(false),
+			first_(true) {}
+	bool found_;
+	int moves_;
+	int sinksource_;
+	/** False if a shorter path to a representative might exist. */
+	bool minimal_;
+	/**
+	 * True if the search ran out of memory and continued in a way which may
+	 * have missed some matrices.
+	 */
+	bool degraded_;
+	/**
+	 * False if the representative reached may not be the first one found by a
+	 * breadth first search, so that the same total may be split differently
+	 * between moves and sink-source mutations.
+	 */
+	bool first_;
+	/** Whether the result is certain to match a full breadth first search. */
+	bool exact() const {
+		return minimal_ && !degraded_ && first_;
+	}
+};
+}
@@ -0,0 +1,108 @@
+/**
+ * shared_index.h
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * Contains SharedIndex, a hash table of solved matrices kept in a memory mapped
+ * file. Any number of processes can map the same file and then read and add
+ * entries without taking any locks, so results found by one run of qvmove are
+ * available to every other run on the host, and persist between runs.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "qv/equiv_quiver_matrix.h"
+
+#include "result.h"
+
+namespace qvmove {
+class SharedIndex {
+	private:
+		typedef cluster::EquivQuiverMatrix Matrix;
+	public:
+		/** Largest matrix which can be stored in the index. */
+		static const int MaxSize = 16;
+		/**
+		 * Version of the file layout and of the meaning of the results stored.
+		 * Increase this whenever either changes, so that old files are rejected.
+		 */
+		static const std::uint64_t Version = 3;
+		/** Number of slots in a newly created index file. */
+		static const std::uint64_t DefaultCapacity = 1 << 18;
+		/**
+		 * Open the index stored in the file at path, creating it if it does not
+		 * exist. The key should identify the moves and representatives used, so
+		 * that results computed with different settings are never mixed up.
+		 */
+		SharedIndex(const std::string& path, std::uint64_t key,
+				std::uint64_t capacity = DefaultCapacity);
+		SharedIndex(const SharedIndex&) = delete;
+		SharedIndex& operator=(const SharedIndex&) = delete;
+		~SharedIndex();
+		/**
+		 * Check whether the file was opened and mapped successfully.
+		 */
+		bool is_open() const;
+		/**
+		 * Look up the result for a matrix equivalent to m. Returns false if there
+		 * is no such entry, in which case result is not changed.
+		 */
+		bool find(const Matrix& m, Result& result) const;
+		/**
+		 * Publish the result for m. Returns false if the table is too full to add
+		 * the entry, or if m cannot be stored.
+		 */
+		bool insert(const Matrix& m, const Result& result);
+		/**
+		 * Check whether m is small enough to be stored, with entries which fit in
+		 * a byte.
+		 */
+		static bool storable(const Matrix& m);
+	private:
+		/** Number of bytes needed to store the upper triangle of a matrix. */
+		static const int EntrySize = MaxSize * (MaxSize - 1) / 2;
+		/** Give up looking for a slot after this many probes. */
+		static const std::uint64_t MaxProbes = 64;
+
+		enum State : std::uint32_t { Empty = 0, Writing = 1, Ready = 2 };
+
+		struct Header {
+			std::uint64_t magic_;
+			std::uint64_t version_;
+			std::uint64_t key_;
+			std::uint64_t capacity_;
+		};
+		struct Slot {
+			std::atomic<std::uint32_t> state_;
+			std::uint32_t hash_;
+			std::int32_t moves_;
+			std::int32_t sinksource_;
+			std::int8_t found_;
+			std::int8_t size_;
+			std::int8_t entries_[EntrySize];
+		};
+
+		int fd_;
+		void* map_;
+		std::size_t length_;
+		Header* header_;
+		Slot* slots_;
+
+		bool matches(const Slot& slot, std::uint32_t hash, const Matrix& m) const;
+};
+}
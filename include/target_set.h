@@ -0,0 +1,73 @@
+/**
+ * target_set.h
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * Contains TargetSet, which checks whether a matrix is one of the class
+ * representatives, or has one of the given underlying graphs. TargetSet can be
+ * used from many threads at once.
+ *
+ * Building and comparing the underlying graph of every matrix is expensive, so
+ * the vertex count, edge count and degree sequence of each target graph are
+ * kept in a table. A graph is only built for matrices whose invariants appear
+ * in the table, and never if there are no target graphs.
+ *
+ * The invariants of a matrix are computed from its quiver, so those of each
+ * target are computed from a quiver with that underlying graph, never from the
+ * graph's own storage. If no such quiver can be found for some target the
+ * table is not used, and a graph is built for every matrix.
+ */
+#pragma once
+
+#include <unordered_set>
+#include <vector>
+
+#include "qv/equiv_quiver_matrix.h"
+#include "qv/equiv_underlying_graph.h"
+
+namespace qvmove {
+class TargetSet {
+	private:
+		typedef cluster::EquivQuiverMatrix Matrix;
+		typedef std::shared_ptr<Matrix> MatrixPtr;
+		typedef std::unordered_set<MatrixPtr> MatrixSet;
+		typedef cluster::EquivUnderlyingGraph Graph;
+		typedef std::shared_ptr<Graph> GraphPtr;
+		typedef std::unordered_set<GraphPtr> GraphSet;
+		/** Vertex count, edge count then sorted vertex degrees. */
+		typedef std::vector<int> Invariants;
+		struct InvariantsHash {
+			std::size_t operator()(const Invariants& inv) const;
+		};
+	public:
+		TargetSet(const MatrixSet& reps, const GraphSet& graphs);
+		/** Check whether the matrix is one of the targets. */
+		bool operator()(const MatrixPtr& matrix) const;
+	private:
+		const MatrixSet& reps_;
+		const GraphSet& graphs_;
+		std::unordered_set<Invariants, InvariantsHash> graph_invariants_;
+		/** Whether graph_invariants_ holds the invariants of every target graph. */
+		bool filter_;
+
+		/** Compute the invariants of the underlying graph of the quiver. */
+		static Invariants invariants(const cluster::IntMatrix& m);
+		/**
+		 * Find a quiver whose underlying graph is the given graph, or return null
+		 * if this fails.
+		 */
+		static MatrixPtr quiver(const Graph& graph);
+};
+}
@@ -0,0 +1,47 @@
+/**
+ * topology.h
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * Contains Topology, which describes the NUMA nodes of the machine and the CPUs
+ * belonging to each, as given by /sys/devices/system/node. If that information
+ * is not available then the whole machine is treated as a single node.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace qvmove {
+class Topology {
+	public:
+		/** Read the topology of the current machine. */
+		Topology();
+		/** Number of NUMA nodes. */
+		int nodes() const;
+		/** CPUs belonging to the given node. */
+		const std::vector<int>& cpus(int node) const;
+		/**
+		 * Restrict the calling thread to run only on the CPUs of the given node.
+		 * Memory the thread touches first is then allocated on that node.
+		 */
+		bool bind(int node) const;
+	private:
+		std::vector<std::vector<int>> cpus_;
+
+		/** Parse a list of CPUs such as "0-3,8-11". */
+		static std::vector<int> parse_list(const std::string& list);
+};
+}
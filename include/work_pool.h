@@ -0,0 +1,134 @@
+/**
+ * work_pool.h
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * Contains WorkPool, a fixed set of worker threads which share out tasks by
+ * work stealing.
+ *
+ * Each worker has its own queue of tasks. Tasks submitted by a worker go on its
+ * own queue and are taken back off in last in first out order, while a worker
+ * with nothing to do steals the oldest task from another worker's queue. A
+ * thread waiting for a group of tasks to finish runs other tasks while it
+ * waits, so tasks can themselves submit and wait for more tasks.
+ *
+ * On a machine with more than one NUMA node the workers are split evenly
+ * between the nodes and bound to them. Tasks can be submitted to a particular
+ * node, and idle workers steal from workers on their own node before trying
+ * those on other nodes. Tasks pinned to a node are never stolen by workers on
+ * other nodes, nor run by threads outside the pool while they wait.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "topology.h"
+
+namespace qvmove {
+class WorkPool {
+	public:
+		typedef std::function<void()> Task;
+		/**
+		 * Counts the unfinished tasks submitted in the group, so that they can be
+		 * waited on together.
+		 */
+		class Group {
+			public:
+				Group()
+					: pending_(0) {}
+				Group(const Group&) = delete;
+				Group& operator=(const Group&) = delete;
+				/** Check whether all tasks in the group have finished. */
+				bool done() const {
+					return pending_.load(std::memory_order_acquire) == 0;
+				}
+			private:
+				friend class WorkPool;
+				std::atomic<long> pending_;
+		};
+
+		/** Start the given number of worker threads. */
+		WorkPool(int threads);
+		WorkPool(const WorkPool&) = delete;
+		WorkPool& operator=(const WorkPool&) = delete;
+		/** Finish any queued tasks and stop the workers. */
+		~WorkPool();
+		/** Add a task to the pool as part of the group. */
+		void submit(Group& group, Task task);
+		/**
+		 * Add a task to the pool as part of the group, preferably to be run on the
+		 * given node. If pinned, only workers on that node may run the task, so
+		 * any memory it allocates is local to the node.
+		 */
+		void submit(Group& group, Task task, int node, bool pinned = false);
+		/**
+		 * Wait for all tasks in the group to finish, running queued tasks in the
+		 * meantime.
+		 */
+		void wait(Group& group);
+		/** Number of worker threads. */
+		int size() const;
+		/** Number of NUMA nodes the workers are spread over. */
+		int nodes() const;
+	private:
+		struct Item {
+			Group* group_;
+			Task task_;
+			/** Node the task is pinned to, or -1 if any thread can run it. */
+			int node_;
+		};
+		struct Queue {
+			std::mutex mutex_;
+			std::deque<Item> items_;
+		};
+
+		Topology topology_;
+		std::vector<std::unique_ptr<Queue>> queues_;
+		/** Node of each worker. */
+		std::vector<int> node_of_;
+		/** Workers on each node. */
+		std::vector<std::vector<int>> workers_on_;
+		/** For each worker, the other queues in the order to steal from them. */
+		std::vector<std::vector<int>> steal_order_;
+		std::vector<std::thread> threads_;
+		std::mutex sleep_mutex_;
+		std::condition_variable wake_;
+		/** Number of queued tasks which are not pinned. */
+		std::atomic<long> queued_;
+		/** Number of queued tasks pinned to each node. */
+		std::unique_ptr<std::atomic<long>[]> pinned_;
+		std::atomic<unsigned> next_queue_;
+		bool stop_;
+
+		/** Index of the calling thread's queue, or -1 if not one of the workers. */
+		int self() const;
+		/** Check whether there is a queued task the given worker can run. */
+		bool runnable(int self) const;
+		/** Check whether the given worker can run the item. */
+		bool allowed(int self, const Item& item) const;
+		/** Add an item to the given queue. */
+		void push(int queue, Item item);
+		/** Run a single task, returning false if there were none to run. */
+		bool run_one(int self);
+		void work(int self);
+};
+}
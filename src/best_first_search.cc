@@ -0,0 +1,105 @@
+/**
+ * best_first_search.cc
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "best_first_search.h"
+
+#include <functional>
+#include <queue>
+
+namespace qvmove {
+
+BestFirstSearch::BestFirstSearch(const std::vector<MovePtr>& moves,
+		const TargetSet& targets, const RepDistance& distance, bool exact)
+	: expander_(moves),
+		targets_(targets),
+		distance_(distance),
+		exact_(exact),
+		progress_(nullptr) {}
+
+Result BestFirstSearch::run(const MatrixPtr& init) const {
+	std::vector<Node> nodes = { { init, Depth(), false } };
+	std::unordered_map<MatrixPtr, Index> seen = { { init, 0 } };
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+	queue.push(entry(nodes[0], 0));
+	while(!queue.empty()) {
+		Index index = queue.top().index_;
+		queue.pop();
+		if(nodes[index].expanded_) {
+			/* Stale entry, left behind when a shorter path was found. */
+			continue;
+		}
+		nodes[index].expanded_ = true;
+		if(progress_) {
+			progress_->search(queue.size(), nodes.size());
+		}
+		MatrixPtr matrix = nodes[index].matrix_;
+		Depth depth = nodes[index].depth_;
+		if(targets_(matrix)) {
+			Result result(depth.moves_, depth.sinksource_);
+			result.minimal_ = exact_ || depth.moves_ + depth.sinksource_
+				<= distance_.lower_bound(*init);
+			/* Another representative the same distance away may come first in
+			 * breadth first order. */
+			result.first_ = false;
+			return result;
+		}
+		expander_(*matrix, [&](const MatrixPtr& m, int move) {
+			Depth d = move == MoveExpander::SinkSource
+				? Depth(depth.moves_, depth.sinksource_ + 1)
+				: Depth(depth.moves_ + 1, depth.sinksource_);
+			Index child = static_cast<Index>(nodes.size());
+			auto ins = seen.emplace(m, child);
+			if(ins.second) {
+				nodes.push_back({ m, d, false });
+			} else {
+				/* In exact mode a matrix is requeued if it is reached by a shorter path
+				 * before it is expanded. The greedy search never requeues. */
+				child = ins.first->second;
+				Node& node = nodes[child];
+				if(!exact_ || node.expanded_ || node.depth_.moves_
+						+ node.depth_.sinksource_ <= d.moves_ + d.sinksource_) {
+					return;
+				}
+				node.depth_ = d;
+			}
+			queue.push(entry(nodes[child], child));
+		});
+	}
+	return Result();
+}
+void BestFirstSearch::progress(Progress* progress) {
+	progress_ = progress;
+}
+BestFirstSearch::Entry BestFirstSearch::entry(const Node& node,
+		Index index) const {
+	int steps = node.depth_.moves_ + node.depth_.sinksource_;
+	if(exact_) {
+		return { steps + distance_.lower_bound(*node.matrix_),
+			node.depth_.moves_, index };
+	}
+	return { distance_.estimate(*node.matrix_), steps, index };
+}
+bool BestFirstSearch::Entry::operator>(const Entry& other) const {
+	if(priority_ != other.priority_) {
+		return priority_ > other.priority_;
+	}
+	if(tie_ != other.tie_) {
+		return tie_ > other.tie_;
+	}
+	return index_ > other.index_;
+}
+
+}
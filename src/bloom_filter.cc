@@ -0,0 +1,47 @@
+/**
+ * bloom_filter.cc
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "bloom_filter.h"
+
+#include <algorithm>
+
+namespace qvmove {
+
+BloomFilter::BloomFilter(std::size_t bytes)
+	: bits_(std::max<std::size_t>(1, bytes / sizeof(std::uint64_t)), 0) {}
+
+bool BloomFilter::insert(std::uint64_t value) {
+	/* Mix the value then derive each bit position by double hashing. */
+	std::uint64_t h1 = value * 0x9e3779b97f4a7c15ULL;
+	h1 ^= h1 >> 32;
+	std::uint64_t h2 = (value ^ (value >> 29)) * 0xbf58476d1ce4e5b9ULL;
+	h2 = (h2 ^ (h2 >> 31)) | 1;
+	std::uint64_t size = bits_.size() * 64;
+	bool present = true;
+	for(int i = 0; i < Hashes; ++i) {
+		std::uint64_t bit = (h1 + i * h2) % size;
+		std::uint64_t mask = std::uint64_t(1) << (bit % 64);
+		std::uint64_t& word = bits_[bit / 64];
+		present = present && (word & mask) != 0;
+		word |= mask;
+	}
+	return present;
+}
+void BloomFilter::clear() {
+	std::fill(bits_.begin(), bits_.end(), 0);
+}
+
+}
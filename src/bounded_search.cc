@@ -0,0 +1,194 @@
+/**
+ * bounded_search.cc
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "bounded_search.h"
+
+#include <algorithm>
+
+#include "bloom_filter.h"
+#include "canonical_form.h"
+
+namespace qvmove {
+namespace {
+/**
+ * Hash the canonical form of m. Equivalent matrices share this hash, while the
+ * hash of the matrix itself is shared by many matrices which are not
+ * equivalent, as it only depends on what does not change under permutation.
+ * Matrices without a canonical form fall back to their own hash.
+ */
+std::uint64_t canonical_hash(const cluster::IntMatrix& m) {
+	std::string key = CanonicalForm::key(m);
+	if(key.empty()) {
+		return m.hash();
+	}
+	/* 64 bit FNV-1a */
+	std::uint64_t result = 0xcbf29ce484222325ULL;
+	for(char c : key) {
+		result ^= static_cast<unsigned char>(c);
+		result *= 0x100000001b3ULL;
+	}
+	return result;
+}
+}
+
+BoundedSearch::BoundedSearch(const std::vector<MovePtr>& moves,
+		const TargetSet& targets, std::size_t budget)
+	: moves_(moves),
+		expander_(moves),
+		targets_(targets),
+		budget_(budget),
+		progress_(nullptr) {}
+
+Result BoundedSearch::run(const MatrixPtr& init) const {
+	std::size_t scratch = Scratch * MoveExpander::matrix_memory(init->num_rows());
+	std::size_t bytes = budget_ > scratch ? budget_ - scratch : 0;
+	int level = 0;
+	{
+		MoveSearch search(init, moves_);
+		search.limit_memory(bytes / 2);
+		while(search.has_next()) {
+			MatrixPtr next = search.next();
+			Depth depth = search.depth();
+			level = depth.moves_ + depth.sinksource_;
+			if(progress_) {
+				progress_->search(search.remaining(), search.size());
+			}
+			if(targets_(next)) {
+				return Result(depth.moves_, depth.sinksource_);
+			}
+			if(search.full()) {
+				break;
+			}
+		}
+		if(!search.full()) {
+			return Result();
+		}
+	}
+	/* Every matrix before this level has been checked, but not necessarily all of
+	 * those in it. */
+	return deepen(init, level, bytes);
+}
+void BoundedSearch::progress(Progress* progress) {
+	progress_ = progress;
+}
+Result BoundedSearch::deepen(const MatrixPtr& init, int start,
+		std::size_t bytes) const {
+	/* Each filter takes a quarter of the budget, with the rest for the stack. */
+	BloomFilter seen(bytes / 4);
+	BloomFilter visited(bytes / 4);
+	std::size_t filters = 2 * MoveExpander::allocated(bytes / 4);
+	std::size_t stack = bytes > filters ? bytes - filters : 0;
+	Result result;
+	result.degraded_ = true;
+	for(int limit = start; ; ++limit) {
+		bool grew = false;
+		visited.clear();
+		if(limited(init, limit, stack, seen, visited, grew, result)) {
+			return result;
+		}
+		/* No new matrices within this depth means there are none further out. */
+		if(!grew) {
+			return result;
+		}
+	}
+}
+bool BoundedSearch::limited(const MatrixPtr& init, int limit,
+		std::size_t bytes, BloomFilter& seen, BloomFilter& visited, bool& grew,
+		Result& result) const {
+	typedef std::pair<MatrixPtr, int> Child;
+	/* The frames are reserved up front, and each child is only kept if it, and
+	 * any larger vector needed to hold it, fit alongside everything already
+	 * kept. */
+	std::size_t matrix = MoveExpander::matrix_memory(init->num_rows());
+	std::vector<Frame> stack;
+	stack.reserve(limit + 1);
+	std::size_t used = MoveExpander::allocated(stack.capacity() * sizeof(Frame));
+	auto release = [&](const Frame& frame) {
+		std::size_t capacity = frame.children_.capacity();
+		if(capacity > 0) {
+			used -= MoveExpander::allocated(capacity * sizeof(Child));
+		}
+		used -= frame.children_.size() * matrix;
+	};
+	/* Check a matrix and push it onto the stack, returning true if a target. */
+	auto visit = [&](const MatrixPtr& m, const Depth& depth) {
+		int steps = depth.moves_ + depth.sinksource_;
+		std::uint64_t hash = canonical_hash(*m);
+		if(visited.insert(hash ^ (steps * 0x9e3779b97f4a7c15ULL))) {
+			return false;
+		}
+		if(!seen.insert(hash)) {
+			grew = true;
+		}
+		if(targets_(m)) {
+			result = Result(depth.moves_, depth.sinksource_);
+			result.degraded_ = true;
+			return true;
+		}
+		if(steps < limit) {
+			stack.push_back({ depth, {}, 0 });
+			Frame& frame = stack.back();
+			std::vector<Child>& children = frame.children_;
+			expander_(*m, [&](const MatrixPtr& child, int move) {
+				std::size_t capacity = children.capacity();
+				std::size_t old = 0;
+				std::size_t grown = 0;
+				if(children.size() == capacity) {
+					/* The old and new vectors are both held while moving to the new. */
+					if(capacity > 0) {
+						old = MoveExpander::allocated(capacity * sizeof(Child));
+					}
+					capacity = std::max<std::size_t>(4, 2 * capacity);
+					grown = MoveExpander::allocated(capacity * sizeof(Child));
+				}
+				if(used + grown + matrix > bytes) {
+					return;
+				}
+				if(grown > 0) {
+					children.reserve(capacity);
+					used += grown - old;
+				}
+				children.emplace_back(child, move);
+				used += matrix;
+			});
+		}
+		return false;
+	};
+	if(visit(init, Depth())) {
+		return true;
+	}
+	while(!stack.empty()) {
+		Frame& top = stack.back();
+		if(top.next_ == top.children_.size()) {
+			release(top);
+			stack.pop_back();
+			continue;
+		}
+		Child child = top.children_[top.next_++];
+		Depth depth = child.second == MoveExpander::SinkSource
+			? Depth(top.depth_.moves_, top.depth_.sinksource_ + 1)
+			: Depth(top.depth_.moves_ + 1, top.depth_.sinksource_);
+		if(progress_) {
+			progress_->search(stack.size(), 0);
+		}
+		if(visit(child.first, depth)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+}
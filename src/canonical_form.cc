@@ -0,0 +1,240 @@
+/**
+ * canonical_form.cc
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "canonical_form.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+namespace qvmove {
+namespace {
+/**
+ * Branch and bound search for the vertex ordering giving the smallest sequence
+ * of entries.
+ *
+ * Whenever two orderings give the same sequence, the permutation taking one to
+ * the other is an automorphism of the matrix. It fixes the vertices the two
+ * orderings share and takes the subtree the best ordering was found in to the
+ * current one, so the rest of the current subtree is skipped. If an
+ * automorphism found earlier fixes every vertex placed so far and takes one
+ * candidate for the next position to another, then both candidates lead to the
+ * same sequences, so only the first is tried. This keeps the search small for
+ * matrices with many symmetries, such as those with many isolated vertices or
+ * repeated components.
+ */
+class Search {
+	public:
+		Search(const cluster::IntMatrix& m)
+			: m_(m),
+				size_(m.num_rows()),
+				cell_of_vertex_(size_),
+				cell_of_position_(size_),
+				perm_(),
+				used_(size_, false),
+				seq_(),
+				best_(),
+				best_perm_(),
+				automorphisms_(),
+				unwind_(-1) {
+			/* Vertices can only be placed at positions matching their invariants. */
+			std::vector<std::vector<int>> inv(size_);
+			for(int v = 0; v < size_; ++v) {
+				for(int j = 0; j < size_; ++j) {
+					inv[v].push_back(m.get(v, j));
+				}
+				std::sort(inv[v].begin(), inv[v].end());
+			}
+			std::vector<int> order(size_);
+			std::iota(order.begin(), order.end(), 0);
+			std::sort(order.begin(), order.end(), [&](int a, int b) {
+					return inv[a] < inv[b];
+				});
+			int cell = 0;
+			for(int p = 0; p < size_; ++p) {
+				if(p > 0 && inv[order[p]] != inv[order[p - 1]]) {
+					++cell;
+				}
+				cell_of_vertex_[order[p]] = cell;
+				cell_of_position_[p] = cell;
+			}
+		}
+		const std::vector<int>& run() {
+			place(0, false);
+			return best_;
+		}
+	private:
+		const cluster::IntMatrix& m_;
+		int size_;
+		std::vector<int> cell_of_vertex_;
+		std::vector<int> cell_of_position_;
+		std::vector<int> perm_;
+		std::vector<bool> used_;
+		std::vector<int> seq_;
+		std::vector<int> best_;
+		/** Ordering of the vertices giving best_. */
+		std::vector<int> best_perm_;
+		/** Automorphisms found so far, each mapping vertex v to a[v]. */
+		std::vector<std::vector<int>> automorphisms_;
+		/** Position to return to, skipping the rest of its subtree, or -1. */
+		int unwind_;
+
+		/** Most automorphisms to keep, as enough to prune are found early. */
+		static const std::size_t MaxAutomorphisms = 64;
+
+		/**
+		 * Place a vertex at position pos. If better is true the sequence so far is
+		 * already smaller than the start of best_.
+		 */
+		void place(int pos, bool better) {
+			if(pos == size_) {
+				if(better || best_.empty()) {
+					best_ = seq_;
+					best_perm_ = perm_;
+				} else {
+					/* Any leaf which is not better is equal to best_. */
+					std::vector<int> a(size_);
+					for(int i = 0; i < size_; ++i) {
+						a[best_perm_[i]] = perm_[i];
+					}
+					if(automorphisms_.size() < MaxAutomorphisms) {
+						automorphisms_.push_back(std::move(a));
+					}
+					unwind_ = static_cast<int>(std::mismatch(perm_.begin(), perm_.end(),
+								best_perm_.begin()).first - perm_.begin());
+				}
+				return;
+			}
+			/* Only the vertices giving the smallest next column can lead to the
+			 * smallest sequence. */
+			std::vector<int> candidates;
+			std::vector<int> column;
+			for(int v = 0; v < size_; ++v) {
+				if(used_[v] || cell_of_vertex_[v] != cell_of_position_[pos]) {
+					continue;
+				}
+				std::vector<int> col;
+				for(int i = 0; i < pos; ++i) {
+					col.push_back(m_.get(perm_[i], v));
+				}
+				if(candidates.empty() || col < column) {
+					candidates.clear();
+					column = col;
+				}
+				if(col == column) {
+					candidates.push_back(v);
+				}
+			}
+			if(!better && !best_.empty()) {
+				auto start = best_.begin() + seq_.size();
+				auto end = start + column.size();
+				if(std::lexicographical_compare(start, end,
+							column.begin(), column.end())) {
+					return;
+				}
+				better = !std::equal(start, end, column.begin());
+			}
+			seq_.insert(seq_.end(), column.begin(), column.end());
+			std::vector<int> tried;
+			for(int v : candidates) {
+				if(symmetric(v, tried)) {
+					continue;
+				}
+				tried.push_back(v);
+				perm_.push_back(v);
+				used_[v] = true;
+				place(pos + 1, better || best_.empty());
+				used_[v] = false;
+				perm_.pop_back();
+				if(unwind_ >= 0 && unwind_ < pos) {
+					break;
+				}
+				unwind_ = -1;
+				/* Once a full sequence exists, later siblings must beat it. */
+				better = false;
+			}
+			seq_.resize(seq_.size() - column.size());
+		}
+		/**
+		 * Check whether an automorphism fixing every placed vertex takes v to one
+		 * of the tried vertices. Uses the orbits of the group generated by the
+		 * automorphisms found so far which fix the placed vertices.
+		 */
+		bool symmetric(int v, const std::vector<int>& tried) const {
+			if(tried.empty() || automorphisms_.empty()) {
+				return false;
+			}
+			std::vector<int> root(size_);
+			std::iota(root.begin(), root.end(), 0);
+			std::function<int(int)> find = [&](int x) {
+				return root[x] == x ? x : root[x] = find(root[x]);
+			};
+			for(auto& a : automorphisms_) {
+				bool fixes = true;
+				for(int p : perm_) {
+					if(a[p] != p) {
+						fixes = false;
+						break;
+					}
+				}
+				if(fixes) {
+					for(int x = 0; x < size_; ++x) {
+						root[find(x)] = find(a[x]);
+					}
+				}
+			}
+			for(int t : tried) {
+				if(find(t) == find(v)) {
+					return true;
+				}
+			}
+			return false;
+		}
+};
+}
+
+std::string CanonicalForm::key(const cluster::IntMatrix& m) {
+	int size = m.num_rows();
+	if(size > MaxSize || size != m.num_cols()) {
+		return std::string();
+	}
+	Search search(m);
+	const std::vector<int>& seq = search.run();
+	std::string result(1, static_cast<char>(size));
+	for(int v : seq) {
+		if(v > 127 || v < -127) {
+			return std::string();
+		}
+		result.push_back(static_cast<char>(v));
+	}
+	return result;
+}
+CanonicalForm::MatrixPtr CanonicalForm::matrix(const std::string& key) {
+	int size = key.empty() ? 0 : static_cast<unsigned char>(key[0]);
+	MatrixPtr result = std::make_shared<Matrix>(size, size);
+	std::size_t k = 1;
+	for(int c = 1; c < size; ++c) {
+		for(int r = 0; r < c; ++r) {
+			int v = static_cast<signed char>(key[k++]);
+			result->set(r, c, v);
+			result->set(c, r, -v);
+		}
+	}
+	return result;
+}
+
+}
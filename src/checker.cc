@@ -16,12 +16,22 @@
  */
 #include "checker.h"
 
+#include <deque>
+#include <unordered_map>
+
+#include "best_first_search.h"
+#include "bounded_search.h"
+#include "canonical_form.h"
+#include "parallel_search.h"
+
 namespace qvmove {
 
 Checker::Checker(InPtr input, OutPtr output,
 		const std::vector<MovePtr>& moves,
 		const MatrixSet& reps,
-		const GraphSet& graphs)
+		const GraphSet& graphs,
+		IndexPtr index,
+		const Options& options)
 	: iter_(*input),
 		input_(input),
 		output_(output),
@@ -29,35 +39,221 @@ Checker::Checker(InPtr input, OutPtr output,
 		loader_(nullptr),
 		reps_(reps),
 		graphs_(graphs),
-		tmp_graph_(std::make_shared<Graph>(cluster::IntMatrix())){}
+		targets_(reps, graphs),
+		index_(index),
+		options_(options),
+		path_(),
+		pool_(),
+		distance_(),
+		cache_(),
+		progress_() {
+	if(options_.budget_ > 0) {
+		options_.threads_ = 1;
+		options_.best_first_ = false;
+	}
+	if(options_.threads_ > 1 && !options_.paths_ && !options_.best_first_) {
+		pool_ = PoolPtr(new WorkPool(options_.threads_));
+	}
+	if(options_.best_first_) {
+		/* The distance estimates only know about representatives, so if graphs
+		 * are also targets the estimates cannot be trusted. */
+		static const MatrixSet none;
+		distance_ = std::unique_ptr<RepDistance>(new RepDistance(
+					graphs_.empty() ? reps_ : none, options_.per_move_));
+	}
+	if(options_.dedupe_ > 0 && !options_.paths_) {
+		cache_ = std::unique_ptr<DedupeCache>(new DedupeCache(options_.dedupe_));
+	}
+	if(options_.progress_ > 0 || !options_.metrics_.empty()) {
+		progress_ = std::unique_ptr<Progress>(new Progress("qvmove",
+					options_.progress_, options_.metrics_));
+	}
+}
 
 void Checker::run() {
+	if(pool_) {
+		run_parallel();
+		return;
+	}
 	while(iter_.has_next()) {
 		MatrixPtr init = iter_.next();
-		loader_ = LoaderPtr(new cluster::MoveClassLoader(init, moves_));
-		bool found = false;
-		while(loader_->has_next()) {
-			MatrixPtr next = loader_->next();
-			tmp_graph_->set_matrix(*next);
-			if(graphs_.find(tmp_graph_) != graphs_.end()) {
-				*output_ << loader_->depth().moves_ << "("<<
-					loader_->depth().sinksource_<< "): " << *init << std::endl;
-				found = true;
-				break;
+		Result result;
+		if(options_.paths_) {
+			/* Neither the index nor the cache hold paths, so always search. */
+			result = search_path(init);
+		} else if(!cache_ || !cache_->find(init, result)) {
+			result = solve(relabel(init));
+			if(cache_) {
+				cache_->insert(init, result);
 			}
-			if(reps_.find(next) != reps_.end()) {
-				/* Is a class representative */
-				*output_ << loader_->depth().moves_ << "("<<
-					loader_->depth().sinksource_<< "): " << *init << std::endl;
-				found = true;
-				break;
+		}
+		write(init, result);
+	}
+}
+void Checker::run_parallel() {
+	/* Each input is its own task, and its search adds further tasks to the pool
+	 * for each chunk of each level. Results are written in input order, with a
+	 * limited number of inputs in flight at any time. */
+	struct Job {
+		MatrixPtr init_;
+		Result result_;
+		WorkPool::Group group_;
+		/** Earlier job for an equivalent input, whose result is reused. */
+		std::shared_ptr<Job> same_;
+	};
+	typedef std::shared_ptr<Job> JobPtr;
+	ParallelSearch search(*pool_, moves_, targets_);
+	search.progress(progress_.get());
+	std::deque<JobPtr> jobs;
+	/* With a cache, the job searching each class of equivalent inputs. */
+	std::unordered_map<MatrixPtr, JobPtr> in_flight;
+	std::size_t max_jobs = 4 * pool_->size();
+	auto finish = [&]() {
+		JobPtr job = jobs.front();
+		jobs.pop_front();
+		pool_->wait(job->group_);
+		if(job->same_) {
+			/* Jobs finish in order, so the earlier one is already done. */
+			job->result_ = job->same_->result_;
+		} else if(cache_) {
+			auto it = in_flight.find(job->init_);
+			if(it != in_flight.end() && it->second == job) {
+				in_flight.erase(it);
+				cache_->insert(job->init_, job->result_);
 			}
 		}
-		if(!found) {
-			*output_ << "None: " << *init << std::endl;
+		write(job->init_, job->result_);
+	};
+	while(iter_.has_next()) {
+		JobPtr job = std::make_shared<Job>();
+		jobs.push_back(job);
+		job->init_ = iter_.next();
+		/* Equivalent inputs which are still being searched are not searched
+		 * again, they take the result of the first once it is done. */
+		bool submit = true;
+		if(cache_) {
+			auto it = in_flight.find(job->init_);
+			if(it != in_flight.end()) {
+				job->same_ = it->second;
+				submit = false;
+			} else if(cache_->find(job->init_, job->result_)) {
+				submit = false;
+			} else {
+				in_flight.emplace(job->init_, job);
+			}
+		}
+		if(submit) {
+			Job* raw = job.get();
+			pool_->submit(job->group_, [this, raw, &search]() {
+					if(!index_ || !index_->find(*raw->init_, raw->result_)) {
+						raw->result_ = search.run(relabel(raw->init_));
+						if(index_) {
+							index_->insert(*raw->init_, raw->result_);
+						}
+					}
+				});
+		}
+		if(jobs.size() >= max_jobs) {
+			finish();
 		}
 	}
+	while(!jobs.empty()) {
+		finish();
+	}
 }
-
+Checker::MatrixPtr Checker::relabel(const MatrixPtr& init) const {
+	if(!cache_ && !index_) {
+		return init;
+	}
+	std::string key = CanonicalForm::key(*init);
+	if(key.empty()) {
+		return init;
+	}
+	return CanonicalForm::matrix(key);
+}
+Result Checker::solve(const MatrixPtr& init) {
+	Result result;
+	if(!index_ || !index_->find(*init, result)) {
+		result = options_.best_first_ ? search_best_first(init) : search(init);
+		/* Only exact results are shared, so the index always agrees with a full
+		 * search. */
+		if(index_ && result.exact()) {
+			index_->insert(*init, result);
+		}
+	}
+	return result;
+}
+Result Checker::search(const MatrixPtr& init) {
+	if(options_.budget_ > 0) {
+		BoundedSearch search(moves_, targets_, options_.budget_);
+		search.progress(progress_.get());
+		return search.run(init);
+	}
+	if(progress_) {
+		/* MoveClassLoader does not expose the size of its queue or its set of
+		 * seen matrices, so use MoveSearch, which finds the matrices in the same
+		 * order and can report both. */
+		MoveSearch search(init, moves_);
+		while(search.has_next()) {
+			MatrixPtr next = search.next();
+			progress_->search(search.remaining(), search.size());
+			if(targets_(next)) {
+				return Result(search.depth().moves_, search.depth().sinksource_);
+			}
+		}
+		return Result();
+	}
+	loader_ = LoaderPtr(new cluster::MoveClassLoader(init, moves_));
+	while(loader_->has_next()) {
+		MatrixPtr next = loader_->next();
+		if(targets_(next)) {
+			return Result(loader_->depth().moves_, loader_->depth().sinksource_);
+		}
+	}
+	return Result();
+}
+Result Checker::search_path(const MatrixPtr& init) {
+	path_.clear();
+	MoveSearch search(init, moves_);
+	while(search.has_next()) {
+		MatrixPtr next = search.next();
+		if(targets_(next)) {
+			for(auto& edge : search.path(search.index())) {
+				path_.emplace_back(edge.move_, search.matrix(edge.child_));
+			}
+			return Result(search.depth().moves_, search.depth().sinksource_);
+		}
+	}
+	return Result();
+}
+Result Checker::search_best_first(const MatrixPtr& init) {
+	BestFirstSearch search(moves_, targets_, *distance_, options_.exact_);
+	search.progress(progress_.get());
+	return search.run(init);
+}
+void Checker::write(const MatrixPtr& init, const Result& result) {
+	if(progress_) {
+		progress_->input_done();
+	}
+	if(result.found_) {
+		*output_ << result.moves_ << "(" << result.sinksource_ << ")"
+			<< (result.minimal_ ? "" : "?") << (result.degraded_ ? "~" : "")
+			<< ": " << *init << std::endl;
+		if(options_.paths_) {
+			for(auto& step : path_) {
+				*output_ << '\t';
+				if(step.first == MoveExpander::SinkSource) {
+					*output_ << "ss";
+				} else {
+					*output_ << step.first;
+				}
+				*output_ << ": " << *step.second << std::endl;
+			}
+		}
+	} else {
+		*output_ << "None" << (result.degraded_ ? "~" : "") << ": " << *init
+			<< std::endl;
+	}
 }
 
+}
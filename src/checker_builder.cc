@@ -28,13 +28,26 @@
 #include "consts.h"
 
 namespace qvmove {
+namespace {
+	/* Spread the bits of a hash, so that sums of hashes rarely collide. */
+	std::uint64_t mix(std::uint64_t h) {
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdULL;
+		h ^= h >> 33;
+		return h;
+	}
+}
 
 	CheckerBuilder::CheckerBuilder() : 
 		in_(), 
 		out_(),
 		moves_(qvmove::consts::Moves), 
 		reps_(qvmove::consts::Reps),
-		graphs_(qvmove::consts::Graphs) {}
+		graphs_(qvmove::consts::Graphs),
+		index_(),
+		options_() {
+		options_.per_move_ = qvmove::consts::MoveWeightChange;
+	}
 	void CheckerBuilder::input(const std::string& ifile) {
 		if(ifile.empty()) {
 			in_ = IPtr(&std::cin, NullDeleter());
@@ -70,8 +83,58 @@ namespace qvmove {
 	void CheckerBuilder::graphs(const _GraphSet& graphs) {
 		graphs_ = graphs;
 	}
+	void CheckerBuilder::index(const std::string& ifile) {
+		index_ = ifile;
+	}
+	void CheckerBuilder::paths(bool paths) {
+		options_.paths_ = paths;
+	}
+	void CheckerBuilder::threads(int threads) {
+		options_.threads_ = threads;
+	}
+	void CheckerBuilder::best_first(bool best_first, bool exact) {
+		options_.best_first_ = best_first;
+		options_.exact_ = exact;
+	}
+	void CheckerBuilder::dedupe(std::size_t limit) {
+		options_.dedupe_ = limit;
+	}
+	void CheckerBuilder::progress(int interval, const std::string& metrics) {
+		options_.progress_ = interval;
+		options_.metrics_ = metrics;
+	}
+	void CheckerBuilder::budget(std::size_t bytes) {
+		options_.budget_ = bytes;
+	}
 	Checker CheckerBuilder::build() {
-		Checker result(in_, out_, moves_, reps_, graphs_);
+		if(options_.paths_ && options_.budget_ > 0) {
+			/* Finding a path means keeping the whole class in memory. */
+			std::cerr << "Paths cannot be found within a memory budget" << std::endl;
+			exit(2);
+		}
+		std::shared_ptr<SharedIndex> index;
+		if(!index_.empty()) {
+			/* Results depend on which moves and targets are used, so the index is
+			 * keyed on these. Only the built in moves can be hashed. */
+			if(moves_ != consts::Moves) {
+				std::cerr << "An index can only be used with the built in moves"
+					<< std::endl;
+				exit(2);
+			}
+			std::uint64_t key = consts::MovesKey;
+			for(auto& rep : reps_) {
+				key += mix(rep->hash());
+			}
+			for(auto& graph : graphs_) {
+				key += mix(graph->hash() * 31);
+			}
+			index = std::make_shared<SharedIndex>(index_, key);
+			if(!index->is_open()) {
+				std::cerr << "Error opening index " << index_ << std::endl;
+				exit(2);
+			}
+		}
+		Checker result(in_, out_, moves_, reps_, graphs_, index, options_);
 		return std::move(result);
 	}
 }
@@ -0,0 +1,256 @@
+/**
+ * class_file.cc
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "class_file.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace qvmove {
+namespace {
+const char Magic[8] = { 'Q', 'V', 'C', 'L', 'A', 'S', 'S', '1' };
+
+template<class T>
+void put(std::ostream& out, const T& value) {
+	out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+template<class T>
+bool get(std::istream& in, T& value) {
+	return static_cast<bool>(
+			in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+/** Keys are at most 254 bytes long, so their lengths fit in a byte. */
+void put_string(std::ostream& out, const std::string& s) {
+	put(out, static_cast<std::uint8_t>(s.size()));
+	out.write(s.data(), s.size());
+}
+bool get_string(std::istream& in, std::string& s) {
+	std::uint8_t length;
+	if(!get(in, length)) {
+		return false;
+	}
+	s.resize(length);
+	return static_cast<bool>(in.read(&s[0], length));
+}
+}
+
+ClassWriter::ClassWriter(const std::string& path)
+	: out_(path, std::ios::binary | std::ios::trunc),
+		count_(0),
+		index_(),
+		block_(),
+		last_(),
+		closed_(false) {
+	/* The header is written again once the counts are known. */
+	class_file::Header header = class_file::Header();
+	put(out_, header);
+}
+ClassWriter::~ClassWriter() {
+	close();
+}
+bool ClassWriter::is_open() const {
+	return out_.is_open();
+}
+void ClassWriter::add(const std::string& key) {
+	if(count_ > 0 && key == last_) {
+		return;
+	}
+	last_ = key;
+	block_.push_back(key);
+	++count_;
+	if(block_.size() == class_file::BlockSize) {
+		write_block();
+	}
+}
+bool ClassWriter::close() {
+	if(closed_) {
+		return static_cast<bool>(out_);
+	}
+	closed_ = true;
+	if(!block_.empty()) {
+		write_block();
+	}
+	class_file::Header header;
+	std::memcpy(header.magic_, Magic, sizeof(Magic));
+	header.count_ = count_;
+	header.blocks_ = index_.size();
+	header.index_ = out_.tellp();
+	for(auto& entry : index_) {
+		put(out_, entry.first);
+		put_string(out_, entry.second);
+	}
+	out_.seekp(0);
+	put(out_, header);
+	out_.close();
+	return !out_.fail();
+}
+std::uint64_t ClassWriter::size() const {
+	return count_;
+}
+void ClassWriter::write_block() {
+	index_.emplace_back(out_.tellp(), block_.front());
+	put(out_, static_cast<std::uint16_t>(block_.size()));
+	put_string(out_, block_.front());
+	for(std::size_t i = 1; i < block_.size(); ++i) {
+		const std::string& prev = block_[i - 1];
+		const std::string& key = block_[i];
+		std::size_t shared = std::mismatch(prev.begin(),
+				prev.begin() + std::min(prev.size(), key.size()), key.begin()).first
+			- prev.begin();
+		put(out_, static_cast<std::uint8_t>(shared));
+		put_string(out_, key.substr(shared));
+	}
+	block_.clear();
+}
+
+ClassReader::ClassReader(const std::string& path)
+	: in_(path, std::ios::binary),
+		ok_(false),
+		failed_(false),
+		header_(),
+		index_(),
+		block_(),
+		pos_(0),
+		next_block_(0),
+		lookup_(),
+		lookup_block_(-1) {
+	ok_ = get(in_, header_)
+		&& std::memcmp(header_.magic_, Magic, sizeof(Magic)) == 0
+		&& static_cast<bool>(in_.seekg(header_.index_));
+	for(std::uint64_t i = 0; ok_ && i < header_.blocks_; ++i) {
+		class_file::IndexEntry entry;
+		ok_ = get(in_, entry.first) && get_string(in_, entry.second);
+		index_.push_back(std::move(entry));
+	}
+}
+bool ClassReader::is_open() const {
+	return ok_;
+}
+bool ClassReader::failed() const {
+	return failed_;
+}
+std::uint64_t ClassReader::size() const {
+	return ok_ ? header_.count_ : 0;
+}
+bool ClassReader::has_next() {
+	while(pos_ == block_.size() && next_block_ < index_.size()) {
+		pos_ = 0;
+		if(!read_block(next_block_++, block_)) {
+			/* Skipping the block would silently lose its keys. */
+			failed_ = true;
+			block_.clear();
+			next_block_ = index_.size();
+		}
+	}
+	return pos_ < block_.size();
+}
+const std::string& ClassReader::next() {
+	return block_[pos_++];
+}
+bool ClassReader::contains(const std::string& key) {
+	/* Find the last block starting at or before the key. */
+	auto it = std::upper_bound(index_.begin(), index_.end(), key,
+			[](const std::string& k, const class_file::IndexEntry& entry) {
+				return k < entry.second;
+			});
+	if(it == index_.begin()) {
+		return false;
+	}
+	std::size_t block = it - index_.begin() - 1;
+	if(block != lookup_block_) {
+		if(!read_block(block, lookup_)) {
+			failed_ = true;
+			lookup_block_ = -1;
+			return false;
+		}
+		lookup_block_ = block;
+	}
+	return std::binary_search(lookup_.begin(), lookup_.end(), key);
+}
+bool ClassReader::read_block(std::size_t block, std::vector<std::string>& keys) {
+	keys.clear();
+	in_.clear();
+	std::uint16_t count;
+	std::string key;
+	if(!in_.seekg(index_[block].first) || !get(in_, count)
+			|| !get_string(in_, key)) {
+		return false;
+	}
+	keys.push_back(key);
+	for(std::uint16_t i = 1; i < count; ++i) {
+		std::uint8_t shared;
+		std::string suffix;
+		if(!get(in_, shared) || !get_string(in_, suffix)
+				|| shared > key.size()) {
+			return false;
+		}
+		key.resize(shared);
+		key += suffix;
+		keys.push_back(key);
+	}
+	return true;
+}
+
+namespace class_file {
+void merge(const std::vector<ClassReader*>& readers, Operation operation,
+		ClassWriter& writer) {
+	std::vector<const std::string*> heads(readers.size(), nullptr);
+	for(std::size_t i = 0; i < readers.size(); ++i) {
+		if(readers[i]->has_next()) {
+			heads[i] = &readers[i]->next();
+		}
+	}
+	while(true) {
+		const std::string* least = nullptr;
+		for(auto head : heads) {
+			if(head != nullptr && (least == nullptr || *head < *least)) {
+				least = head;
+			}
+		}
+		if(least == nullptr) {
+			break;
+		}
+		/* Copy the key, as advancing the reader it came from may invalidate it. */
+		std::string key = *least;
+		std::size_t count = 0;
+		bool in_first = false;
+		for(std::size_t i = 0; i < readers.size(); ++i) {
+			if(heads[i] != nullptr && *heads[i] == key) {
+				++count;
+				in_first = in_first || i == 0;
+				heads[i] = readers[i]->has_next() ? &readers[i]->next() : nullptr;
+			}
+		}
+		bool keep = false;
+		switch(operation) {
+			case Operation::Union:
+				keep = true;
+				break;
+			case Operation::Intersect:
+				keep = count == readers.size();
+				break;
+			case Operation::Difference:
+				keep = in_first && count == 1;
+				break;
+		}
+		if(keep) {
+			writer.add(key);
+		}
+	}
+}
+}
+
+}
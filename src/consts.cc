@@ -23,27 +23,100 @@
  */
 #include "consts.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+
 #include "qv/mass_finite_check.h"
 
 namespace qvmove {
 namespace consts {
 
+int MoveWeightChange = 0;
+/*
+ * Connection requirements cannot be inspected once created, so only their
+ * number goes into MovesKey. Increase the starting value whenever one of them
+ * is changed.
+ */
+std::uint64_t MovesKey = 1;
+
 namespace {
+	void add_key(std::uint64_t& key, std::uint64_t value) {
+		key = (key ^ value) * 1099511628211ULL;
+	}
+	void add_key(std::uint64_t& key, const cluster::IntMatrix& m) {
+		add_key(key, m.num_rows());
+		add_key(key, m.num_cols());
+		for(int i = 0; i < m.num_rows(); ++i) {
+			for(int j = 0; j < m.num_cols(); ++j) {
+				add_key(key, static_cast<std::uint64_t>(m.get(i, j)));
+			}
+		}
+	}
+	/*
+	 * Sum of the hashes of the finite requirements created for the next move.
+	 * Arguments can be evaluated in any order, so the order of the requirements
+	 * is not used.
+	 */
+	std::uint64_t finite_key = 0;
+	/*
+	 * Sum over each weight of the difference between the number of arrows of
+	 * that weight in a and in b.
+	 */
+	int weight_change(const cluster::IntMatrix& a, const cluster::IntMatrix& b) {
+		std::map<int, int> counts;
+		for(int r = 0; r < a.num_rows(); ++r) {
+			for(int c = r + 1; c < a.num_cols(); ++c) {
+				++counts[std::abs(a.get(r, c))];
+			}
+		}
+		for(int r = 0; r < b.num_rows(); ++r) {
+			for(int c = r + 1; c < b.num_cols(); ++c) {
+				--counts[std::abs(b.get(r, c))];
+			}
+		}
+		int result = 0;
+		for(auto& count : counts) {
+			if(count.first != 0) {
+				result += std::abs(count.second);
+			}
+		}
+		return result;
+	}
+	/*
+	 * Create a move, keeping MoveWeightChange and MovesKey up to date with each move
+	 * created. The number of finite requirements is given by the caller.
+	 */
+	std::shared_ptr<cluster::MMIMove> create(const std::string& a,
+			const std::string& b, std::initializer_list<int> c,
+			std::initializer_list<cluster::MMIMove::ConnReq> r, int finite) {
+		cluster::IntMatrix ma(a);
+		cluster::IntMatrix mb(b);
+		MoveWeightChange = std::max(MoveWeightChange, weight_change(ma, mb));
+		add_key(MovesKey, ma);
+		add_key(MovesKey, mb);
+		add_key(MovesKey, c.size());
+		for(int v : c) {
+			add_key(MovesKey, v);
+		}
+		add_key(MovesKey, r.size());
+		add_key(MovesKey, finite);
+		add_key(MovesKey, finite_key);
+		finite_key = 0;
+		return std::make_shared<cluster::MMIMove>(ma, mb,
+				std::vector<int>(c), std::vector<cluster::MMIMove::ConnReq>(r));
+	}
 	std::shared_ptr<cluster::MMIMove> make_move(const std::string& a,
 			const std::string& b, std::initializer_list<int> c,
 			std::initializer_list<cluster::MMIMove::ConnReq> r) {
-		return std::make_shared<cluster::MMIMove>(
-				cluster::IntMatrix(a), cluster::IntMatrix(b),
-				std::vector<int>(c), std::vector<cluster::MMIMove::ConnReq>(r));
+		return create(a, b, c, r, 0);
 	}
 	template<typename F>
 	std::shared_ptr<cluster::MMIMove> make_move(const std::string& a,
 			const std::string& b, std::initializer_list<int> c,
 			std::initializer_list<cluster::MMIMove::ConnReq> r,
 			cluster::mmi_conn::Finite<F> atob) {
-		auto res = std::make_shared<cluster::MMIMove>(
-				cluster::IntMatrix(a), cluster::IntMatrix(b),
-				std::vector<int>(c), std::vector<cluster::MMIMove::ConnReq>(r));
+		auto res = create(a, b, c, r, 1);
 		res->finite_req_atob(atob);
 		return res;
 	}
@@ -53,9 +126,7 @@ namespace {
 			std::initializer_list<cluster::MMIMove::ConnReq> r,
 			cluster::mmi_conn::Finite<F1> atob,
 			cluster::mmi_conn::Finite<F2> btoa) {
-		auto res = std::make_shared<cluster::MMIMove>(
-				cluster::IntMatrix(a), cluster::IntMatrix(b),
-				std::vector<int>(c), std::vector<cluster::MMIMove::ConnReq>(r));
+		auto res = create(a, b, c, r, 2);
 		res->finite_req_atob(atob);
 		res->finite_req_btoa(btoa);
 		return res;
@@ -75,6 +146,14 @@ namespace {
 	};
 	cluster::MassFiniteCheck MassFinite::chk;
 	typedef cluster::mmi_conn::Finite<MassFinite> FinReq;
+	/* Create a finite requirement, adding its matrix to the key of the move. */
+	FinReq finite(const std::string& a) {
+		cluster::EquivQuiverMatrix m(a);
+		std::uint64_t key = 0;
+		add_key(key, m);
+		finite_key += key;
+		return FinReq(m);
+	}
 }
 using namespace cluster::mmi_conn;
 
@@ -290,38 +369,38 @@ std::vector<std::shared_ptr<cluster::MMIMove>> Moves = {
 			"{ { 0 -1 1 } { 1 0 -1 } { -1 1 0 } }",
 			{0, 2},
 			{ConnectedTo(2), ConnectedTo(0)},
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 0 1 } { 0 0 0 } { -1 0 0 } }")),
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 0 0 } { 0 0 0 } { 0 0 0 } }")) ),
+			finite("{ { 0 0 1 } { 0 0 0 } { -1 0 0 } }"),
+			finite("{ { 0 0 0 } { 0 0 0 } { 0 0 0 } }") ),
 	make_move(/*Transpose*/
 			"{ { 0 -1 0 } { 1 0 -1 } { 0 1 0 } }",
 			"{ { 0 1 -1 } { -1 0 1 } { 1 -1 0 } }",
 			{0, 2},
 			{ConnectedTo(2), ConnectedTo(0)},
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 0 -1 } { 0 0 0 } { 1 0 0 } }")),
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 0 0 } { 0 0 0 } { 0 0 0 } }")) ),
+			finite("{ { 0 0 -1 } { 0 0 0 } { 1 0 0 } }"),
+			finite("{ { 0 0 0 } { 0 0 0 } { 0 0 0 } }") ),
 	/* 29 & 30 */
 	make_move("{ { 0 1 -1 0 0 } { -1 0 1 0 -1 } { 1 -1 0 1 0 } { 0 0 -1 0 1 } { 0 1 0 -1 0 } }",
 			"{ { 0 -1 0 0 0 } { 1 0 -1 0 1 } { 0 1 0 1 -1 } { 0 0 -1 0 1 } { 0 -1 1 -1 0 } }",
 			{2, 4},
 			{Unconnected(), Unconnected()},
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 0 0 0 0 } { 0 0 -1 0 0 } { 0 1 0 1 0 } { 0 0 -1 0 1 } { 0 0 0 -1 0 } }")) ),
+			finite("{ { 0 0 0 0 0 } { 0 0 -1 0 0 } { 0 1 0 1 0 } { 0 0 -1 0 1 } { 0 0 0 -1 0 } }") ),
 	make_move(/*Transpose*/
 			"{ { 0 -1 1 0 0 } { 1 0 -1 0 1 } { -1 1 0 -1 0 } { 0 0 1 0 -1 } { 0 -1 0 1 0 } }",
 			"{ { 0 1 0 0 0 } { -1 0 1 0 -1 } { 0 -1 0 -1 1 } { 0 0 1 0 -1 } { 0 1 -1 1 0 } }",
 			{2, 4},
 			{Unconnected(), Unconnected()},
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 0 0 0 0 } { 0 0 1 0 0 } { 0 -1 0 -1 0 } { 0 0 1 0 -1 } { 0 0 0 1 0 } }")) ),
+			finite("{ { 0 0 0 0 0 } { 0 0 1 0 0 } { 0 -1 0 -1 0 } { 0 0 1 0 -1 } { 0 0 0 1 0 } }") ),
 	make_move("{ { 0 -1 0 0 0 0 0 0 } { 1 0 -1 0 0 0 0 1 } { 0 1 0 1 0 0 0 -1 } { 0 0 -1 0 1 0 0 0 } { 0 0 0 -1 0 1 0 0 } { 0 0 0 0 -1 0 1 0 } { 0 0 0 0 0 -1 0 0 } { 0 -1 1 0 0 0 0 0 } }",
 			"{ { 0 1 -1 0 0 0 0 0 } { -1 0 1 0 0 0 0 -1 } { 1 -1 0 1 0 0 0 0 } { 0 0 -1 0 1 0 0 0 } { 0 0 0 -1 0 1 0 0 } { 0 0 0 0 -1 0 1 0 } { 0 0 0 0 0 -1 0 0 } { 0 1 0 0 0 0 0 0 } }",
 			{0, 5, 7},
 			{Line(), LineTo(7), LineTo(5)},
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 0 -1 0 0 0 0 0 } { 0 0 0 0 0 0 0 0 } { 1 0 0 1 0 0 0 0 } { 0 0 -1 0 1 0 0 0 } { 0 0 0 -1 0 1 0 0 } { 0 0 0 0 -1 0 1 0 } { 0 0 0 0 0 -1 0 0 } { 0 0 0 0 0 0 0 0 } }")) ),
+			finite("{ { 0 0 -1 0 0 0 0 0 } { 0 0 0 0 0 0 0 0 } { 1 0 0 1 0 0 0 0 } { 0 0 -1 0 1 0 0 0 } { 0 0 0 -1 0 1 0 0 } { 0 0 0 0 -1 0 1 0 } { 0 0 0 0 0 -1 0 0 } { 0 0 0 0 0 0 0 0 } }") ),
 	make_move(/*Transpose*/
 			"{ { 0 1 0 0 0 0 0 0 } { -1 0 1 0 0 0 0 -1 } { 0 -1 0 -1 0 0 0 1 } { 0 0 1 0 -1 0 0 0 } { 0 0 0 1 0 -1 0 0 } { 0 0 0 0 1 0 -1 0 } { 0 0 0 0 0 1 0 0 } { 0 1 -1 0 0 0 0 0 } }",
 			"{ { 0 -1 1 0 0 0 0 0 } { 1 0 -1 0 0 0 0 1 } { -1 1 0 -1 0 0 0 0 } { 0 0 1 0 -1 0 0 0 } { 0 0 0 1 0 -1 0 0 } { 0 0 0 0 1 0 -1 0 } { 0 0 0 0 0 1 0 0 } { 0 -1 0 0 0 0 0 0 } }",
 			{0, 5, 7},
 			{Line(), LineTo(7), LineTo(5)},
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 0 1 0 0 0 0 0 } { 0 0 0 0 0 0 0 0 } { -1 0 0 -1 0 0 0 0 } { 0 0 1 0 -1 0 0 0 } { 0 0 0 1 0 -1 0 0 } { 0 0 0 0 1 0 -1 0 } { 0 0 0 0 0 1 0 0 } { 0 0 0 0 0 0 0 0 } }")) ),
+			finite("{ { 0 0 1 0 0 0 0 0 } { 0 0 0 0 0 0 0 0 } { -1 0 0 -1 0 0 0 0 } { 0 0 1 0 -1 0 0 0 } { 0 0 0 1 0 -1 0 0 } { 0 0 0 0 1 0 -1 0 } { 0 0 0 0 0 1 0 0 } { 0 0 0 0 0 0 0 0 } }") ),
 	make_move("{ { 0 -1 0 0 0 0 0 } { 1 0 -1 0 0 1 0 } { 0 1 0 1 0 -1 0 } { 0 0 -1 0 1 0 0 } { 0 0 0 -1 0 1 0 } { 0 -1 1 0 -1 0 1 } { 0 0 0 0 0 -1 0 } }",
 			"{ { 0 1 -1 0 0 0 0 } { -1 0 1 0 0 -1 0 } { 1 -1 0 1 0 0 0 } { 0 0 -1 0 1 0 0 } { 0 0 0 -1 0 1 0 } { 0 1 0 0 -1 0 1 } { 0 0 0 0 0 -1 0 } }",
 			{ 0 }, {Line()}),
@@ -336,60 +415,60 @@ std::vector<std::shared_ptr<cluster::MMIMove>> Moves = {
 	make_move("{ { 0 1 0 0 0 0 } { -1 0 1 0 0 0 } { 0 -1 0 -1 0 1 } { 0 0 1 0 1 -1 } { 0 0 0 -1 0 0 } { 0 0 -1 1 0 0 } }",
 		"{ { 0 -1 1 0 0 0 } { 1 0 -1 0 0 0 } { -1 1 0 1 0 0 } { 0 0 -1 0 -1 1 } { 0 0 0 1 0 -1 } { 0 0 0 -1 1 0 } }",
 		{0,5,4},{ConnectedTo(5),ConnectedTo(0),Line()},
-		FinReq(cluster::EquivQuiverMatrix("{ { 0 -1 1 0 0 0 } { 1 0 -1 0 0 0 } { -1 1 0 0 0 0 } { 0 0 0 0 0 0 } { 0 0 0 0 0 -1 } { 0 0 0 0 1 0 } }")),
-		FinReq(cluster::EquivQuiverMatrix("{ { 0 0 0 0 0 0 } { 0 0 0 0 0 0 } { 0 0 0 -1 0 1 } { 0 0 1 0 1 -1 } { 0 0 0 -1 0 0 } { 0 0 -1 1 0 0 } }")) ),
+		finite("{ { 0 -1 1 0 0 0 } { 1 0 -1 0 0 0 } { -1 1 0 0 0 0 } { 0 0 0 0 0 0 } { 0 0 0 0 0 -1 } { 0 0 0 0 1 0 } }"),
+		finite("{ { 0 0 0 0 0 0 } { 0 0 0 0 0 0 } { 0 0 0 -1 0 1 } { 0 0 1 0 1 -1 } { 0 0 0 -1 0 0 } { 0 0 -1 1 0 0 } }") ),
 	make_move(/* Transpose */
 		"{ { 0 -1 0 0 0 0 } { 1 0 -1 0 0 0 } { 0 1 0 1 0 -1 } { 0 0 -1 0 -1 1 } { 0 0 0 1 0 0 } { 0 0 1 -1 0 0 } }",
 		"{ { 0 1 -1 0 0 0 } { -1 0 1 0 0 0 } { 1 -1 0 -1 0 0 } { 0 0 1 0 1 -1 } { 0 0 0 -1 0 1 } { 0 0 0 1 -1 0 } }",
 		{0,5,4},{ConnectedTo(5),ConnectedTo(0),Line()},
-		FinReq(cluster::EquivQuiverMatrix("{ { 0 1 -1 0 0 0 } { -1 0 1 0 0 0 } { 1 -1 0 0 0 0 } { 0 0 0 0 0 0 } { 0 0 0 0 0 1 } { 0 0 0 0 -1 0 } }")),
-		FinReq(cluster::EquivQuiverMatrix("{ { 0 0 0 0 0 0 } { 0 0 0 0 0 0 } { 0 0 0 1 0 -1 } { 0 0 -1 0 -1 1 } { 0 0 0 1 0 0 } { 0 0 1 -1 0 0 } }")) ),
+		finite("{ { 0 1 -1 0 0 0 } { -1 0 1 0 0 0 } { 1 -1 0 0 0 0 } { 0 0 0 0 0 0 } { 0 0 0 0 0 1 } { 0 0 0 0 -1 0 } }"),
+		finite("{ { 0 0 0 0 0 0 } { 0 0 0 0 0 0 } { 0 0 0 1 0 -1 } { 0 0 -1 0 -1 1 } { 0 0 0 1 0 0 } { 0 0 1 -1 0 0 } }") ),
 	/* 33 & 34 */
 	make_move("{ { 0 1 0 -1 0 0 } { -1 0 1 1 0 0 } { 0 -1 0 0 0 0 } { 1 -1 0 0 1 -1 } { 0 0 0 -1 0 1 } { 0 0 0 1 -1 0 } }",
 			"{ { 0 -1 1 0 0 0 } { 1 0 -1 -1 0 0 } { -1 1 0 0 0 0 } { 0 1 0 0 1 -1 } { 0 0 0 -1 0 1 } { 0 0 0 1 -1 0 } }",
 			{0,5,2},{ConnectedTo(5),ConnectedTo(0),Line()},
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 0 1 0 0 0 } { 0 0 0 0 0 0 } { -1 0 0 0 0 0 } { 0 0 0 0 -1 0 } { 0 0 0 1 0 -1 } { 0 0 0 0 1 0 } }")) ),
+			finite("{ { 0 0 1 0 0 0 } { 0 0 0 0 0 0 } { -1 0 0 0 0 0 } { 0 0 0 0 -1 0 } { 0 0 0 1 0 -1 } { 0 0 0 0 1 0 } }") ),
 	make_move(/*Transpose*/
 			"{ { 0 -1 0 1 0 0 } { 1 0 -1 -1 0 0 } { 0 1 0 0 0 0 } { -1 1 0 0 -1 1 } { 0 0 0 1 0 -1 } { 0 0 0 -1 1 0 } }",
 			"{ { 0 1 -1 0 0 0 } { -1 0 1 1 0 0 } { 1 -1 0 0 0 0 } { 0 -1 0 0 -1 1 } { 0 0 0 1 0 -1 } { 0 0 0 -1 1 0 } }",
 			{0,5,2},{ConnectedTo(5),ConnectedTo(0),Line()},
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 0 -1 0 0 0 } { 0 0 0 0 0 0 } { 1 0 0 0 0 0 } { 0 0 0 0 1 0 } { 0 0 0 -1 0 1 } { 0 0 0 0 -1 0 } }")) ),
+			finite("{ { 0 0 -1 0 0 0 } { 0 0 0 0 0 0 } { 1 0 0 0 0 0 } { 0 0 0 0 1 0 } { 0 0 0 -1 0 1 } { 0 0 0 0 -1 0 } }") ),
 	/* 35 */
 	make_move(
 			"{ { 0 -1 0 0 0 } { 1 0 1 0 -1 } { 0 -1 0 -1 1 } { 0 0 1 0 0 } { 0 1 -1 0 0 } }",
 			"{ { 0 1 -1 0 0 } { -1 0 1 0 0 } { 1 -1 0 1 -1 } { 0 0 -1 0 1 } { 0 0 1 -1 0 } }",
 			{0, 4, 3}, {ConnectedTo(4), ConnectedTo(0), Line()},
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 1 0 0 0 } { -1 0 0 0 0 } { 0 0 0 0 0 } { 0 0 0 0 1 } { 0 0 0 -1 0 } }")),
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 0 0 0 0 } { 0 0 0 0 0 } { 0 0 0 1 0 } { 0 0 -1 0 1 } { 0 0 0 -1 0 } }")) ),
+			finite("{ { 0 1 0 0 0 } { -1 0 0 0 0 } { 0 0 0 0 0 } { 0 0 0 0 1 } { 0 0 0 -1 0 } }"),
+			finite("{ { 0 0 0 0 0 } { 0 0 0 0 0 } { 0 0 0 1 0 } { 0 0 -1 0 1 } { 0 0 0 -1 0 } }") ),
 	make_move(/*Transpose*/
 			"{ { 0 1 0 0 0 } { -1 0 -1 0 1 } { 0 1 0 1 -1 } { 0 0 -1 0 0 } { 0 -1 1 0 0 } }",
 			"{ { 0 -1 1 0 0 } { 1 0 -1 0 0 } { -1 1 0 -1 1 } { 0 0 1 0 -1 } { 0 0 -1 1 0 } }",
 			{0, 4, 3}, {ConnectedTo(4), ConnectedTo(0), Line()},
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 -1 0 0 0 } { 1 0 0 0 0 } { 0 0 0 0 0 } { 0 0 0 0 -1 } { 0 0 0 1 0 } }")),
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 0 0 0 0 } { 0 0 0 0 0 } { 0 0 0 -1 0 } { 0 0 1 0 -1 } { 0 0 0 1 0 } }")) ),
+			finite("{ { 0 -1 0 0 0 } { 1 0 0 0 0 } { 0 0 0 0 0 } { 0 0 0 0 -1 } { 0 0 0 1 0 } }"),
+			finite("{ { 0 0 0 0 0 } { 0 0 0 0 0 } { 0 0 0 -1 0 } { 0 0 1 0 -1 } { 0 0 0 1 0 } }") ),
 	/* 25 & 26 */
 	make_move(
 			"{ { 0 -1 0 0 0 0 1 0 } { 1 0 1 0 0 0 -1 0 } { 0 -1 0 1 0 0 0 0 } { 0 0 -1 0 -1 0 1 0 } { 0 0 0 1 0 1 -1 -1 } { 0 0 0 0 -1 0 1 0 } { -1 1 0 -1 1 -1 0 0 } { 0 0 0 0 1 0 0 0 } }",
 			"{ { 0 -1 0 0 0 0 0 0 } { 1 0 -1 0 0 0 1 0 } { 0 1 0 1 0 0 -1 0 } { 0 0 -1 0 1 0 0 0 } { 0 0 0 -1 0 0 1 -1 } { 0 0 0 0 0 0 1 -1 } { 0 -1 1 0 -1 -1 0 1 } { 0 0 0 0 1 1 -1 0 } }",
 			{0,7},{Line(), Line()},
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 -1 0 0 0 0 0 0 } { 1 0 -1 0 0 0 0 0 } { 0 1 0 1 0 0 0 0 } { 0 0 -1 0 1 0 0 0 } { 0 0 0 -1 0 0 0 -1 } { 0 0 0 0 0 0 0 0 } { 0 0 0 0 0 0 0 -1 } { 0 0 0 0 1 0 1 0 } }") ),
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 -1 0 0 0 0 0 0 } { 1 0 1 0 0 0 0 0 } { 0 -1 0 1 0 0 0 0 } { 0 0 -1 0 -1 0 0 0 } { 0 0 0 1 0 1 0 -1 } { 0 0 0 0 -1 0 0 0 } { 0 0 0 0 0 0 0 0 } { 0 0 0 0 1 0 0 0 } }") ) ),
+			finite("{ { 0 -1 0 0 0 0 0 0 } { 1 0 -1 0 0 0 0 0 } { 0 1 0 1 0 0 0 0 } { 0 0 -1 0 1 0 0 0 } { 0 0 0 -1 0 0 0 -1 } { 0 0 0 0 0 0 0 0 } { 0 0 0 0 0 0 0 -1 } { 0 0 0 0 1 0 1 0 } }"),
+			finite("{ { 0 -1 0 0 0 0 0 0 } { 1 0 1 0 0 0 0 0 } { 0 -1 0 1 0 0 0 0 } { 0 0 -1 0 -1 0 0 0 } { 0 0 0 1 0 1 0 -1 } { 0 0 0 0 -1 0 0 0 } { 0 0 0 0 0 0 0 0 } { 0 0 0 0 1 0 0 0 } }") ),
 	make_move(/* Transpose */
 			"{ { 0 1 0 0 0 0 -1 0 } { -1 0 -1 0 0 0 1 0 } { 0 1 0 -1 0 0 0 0 } { 0 0 1 0 1 0 -1 0 } { 0 0 0 -1 0 -1 1 1 } { 0 0 0 0 1 0 -1 0 } { 1 -1 0 1 -1 1 0 0 } { 0 0 0 0 -1 0 0 0 } }",
 			"{ { 0 1 0 0 0 0 0 0 } { -1 0 1 0 0 0 -1 0 } { 0 -1 0 -1 0 0 1 0 } { 0 0 1 0 -1 0 0 0 } { 0 0 0 1 0 0 -1 1 } { 0 0 0 0 0 0 -1 1 } { 0 1 -1 0 1 1 0 -1 } { 0 0 0 0 -1 -1 1 0 } }",
 			{0,7},{Line(), Line()},
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 1 0 0 0 0 0 0 } { -1 0 1 0 0 0 0 0 } { 0 -1 0 -1 0 0 0 0 } { 0 0 1 0 -1 0 0 0 } { 0 0 0 1 0 0 0 1 } { 0 0 0 0 0 0 0 0 } { 0 0 0 0 0 0 0 1 } { 0 0 0 0 -1 0 -1 0 } }") ),
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 1 0 0 0 0 0 0 } { -1 0 -1 0 0 0 0 0 } { 0 1 0 -1 0 0 0 0 } { 0 0 1 0 1 0 0 0 } { 0 0 0 -1 0 -1 0 1 } { 0 0 0 0 1 0 0 0 } { 0 0 0 0 0 0 0 0 } { 0 0 0 0 -1 0 0 0 } }") ) ),
+			finite("{ { 0 1 0 0 0 0 0 0 } { -1 0 1 0 0 0 0 0 } { 0 -1 0 -1 0 0 0 0 } { 0 0 1 0 -1 0 0 0 } { 0 0 0 1 0 0 0 1 } { 0 0 0 0 0 0 0 0 } { 0 0 0 0 0 0 0 1 } { 0 0 0 0 -1 0 -1 0 } }"),
+			finite("{ { 0 1 0 0 0 0 0 0 } { -1 0 -1 0 0 0 0 0 } { 0 1 0 -1 0 0 0 0 } { 0 0 1 0 1 0 0 0 } { 0 0 0 -1 0 -1 0 1 } { 0 0 0 0 1 0 0 0 } { 0 0 0 0 0 0 0 0 } { 0 0 0 0 -1 0 0 0 } }") ),
 	make_move(
 			"{ { 0 1 0 -1 0 1 } { -1 0 1 1 0 0 } { 0 -1 0 0 0 0 } { 1 -1 0 0 1 -1 } { 0 0 0 -1 0 1 } { -1 0 0 1 -1 0 } }",
 			"{ { 0 -1 1 0 0 1 } { 1 0 -1 -1 0 0 } { -1 1 0 0 0 0 } { 0 1 0 0 1 -1 } { 0 0 0 -1 0 1 } { -1 0 0 1 -1 } }",
 			{0,5,2,4},{ConnectedTo(5),ConnectedTo(0),Line(),Line()},
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 0 1 0 0 1 } { 0 0 0 0 0 0 } { -1 0 0 0 0 0 } { 0 0 0 0 1 -1 } { 0 0 0 -1 0 1 } { -1 0 0 1 -1 0 } }")) ),
+			finite("{ { 0 0 1 0 0 1 } { 0 0 0 0 0 0 } { -1 0 0 0 0 0 } { 0 0 0 0 1 -1 } { 0 0 0 -1 0 1 } { -1 0 0 1 -1 0 } }") ),
 	make_move(/*Transpose*/
 			"{ { 0 -1 0 1 0 -1 } { 1 0 -1 -1 0 0 } { 0 1 0 0 0 0 } { -1 1 0 0 -1 1 } { 0 0 0 1 0 -1 } { 1 0 0 -1 1 0 } }",
 			"{ { 0 1 -1 0 0 -1 } { -1 0 1 1 0 0 } { 1 -1 0 0 0 0 } { 0 -1 0 0 -1 1 } { 0 0 0 1 0 -1 } { 1 0 0 -1 1 } }",
 			{0,5,2,4},{ConnectedTo(5),ConnectedTo(0),Line(),Line()},
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 0 -1 0 0 -1 } { 0 0 0 0 0 0 } { 1 0 0 0 0 0 } { 0 0 0 0 -1 1 } { 0 0 0 1 0 -1 } { 1 0 0 -1 1 0 } }")) ),
+			finite("{ { 0 0 -1 0 0 -1 } { 0 0 0 0 0 0 } { 1 0 0 0 0 0 } { 0 0 0 0 -1 1 } { 0 0 0 1 0 -1 } { 1 0 0 -1 1 0 } }") ),
 	/* 10x10 special */
 	make_move(
 			"{ { 0 -1 0 0 0 0 0 0 0 0 } { 1 0 -1 0 0 0 0 0 0 0 } { 0 1 0 -1 0 0 0 0 0 1 } { 0 0 1 0 1 0 0 0 0 -1 } { 0 0 0 -1 0 1 0 0 0 0 } { 0 0 0 0 -1 0 -1 0 1 0 } { 0 0 0 0 0 1 0 1 -1 0 } { 0 0 0 0 0 0 -1 0 1 0 } { 0 0 0 0 0 -1 1 -1 0 1 } { 0 0 -1 1 0 0 0 0 -1 0 } }",
@@ -403,24 +482,24 @@ std::vector<std::shared_ptr<cluster::MMIMove>> Moves = {
 			"{ { 0 0 0 -1 1 0 } { 0 0 0 1 0 -1 } { 0 0 0 -1 0 0 } { 1 -1 1 0 -1 1 } { -1 0 0 1 0 0 } { 0 1 0 -1 0 0 } }",
 			"{ { 0 -1 0 1 0 0 } { 1 0 1 -1 0 0 } { 0 -1 0 1 -1 0 } { -1 1 -1 0 1 -1 } { 0 0 1 -1 0 1 } { 0 0 0 1 -1 0 } }",
 			{ 0, 4 }, { Line(), Line() },
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 -1 0 0 0 0 } { 1 0 1 0 0 0 } { 0 -1 0 0 -1 0 } { 0 0 0 0 0 0 } { 0 0 1 0 0 1 } { 0 0 0 0 -1 0 } }")) ),
+			finite("{ { 0 -1 0 0 0 0 } { 1 0 1 0 0 0 } { 0 -1 0 0 -1 0 } { 0 0 0 0 0 0 } { 0 0 1 0 0 1 } { 0 0 0 0 -1 0 } }") ),
 	make_move(/*Transpose*/
 			"{ { 0 0 0 1 -1 0 } { 0 0 0 -1 0 1 } { 0 0 0 1 0 0 } { -1 1 -1 0 1 -1 } { 1 0 0 -1 0 0 } { 0 -1 0 1 0 0 } }",
 			"{ { 0 1 0 -1 0 0 } { -1 0 -1 1 0 0 } { 0 1 0 -1 1 0 } { 1 -1 1 0 -1 1 } { 0 0 -1 1 0 -1 } { 0 0 0 -1 1 0 } }",
 			{ 0, 4 }, { Line(), Line() },
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 1 0 0 0 0 } { -1 0 -1 0 0 0 } { 0 1 0 0 1 0 } { 0 0 0 0 0 0 } { 0 0 -1 0 0 -1 } { 0 0 0 0 1 0 } }")) ),
+			finite("{ { 0 1 0 0 0 0 } { -1 0 -1 0 0 0 } { 0 1 0 0 1 0 } { 0 0 0 0 0 0 } { 0 0 -1 0 0 -1 } { 0 0 0 0 1 0 } }") ),
 	make_move(
 			"{ { 0 -1 0 1 0 0 } { 1 0 1 -1 0 0 } { 0 -1 0 1 -1 0 } { -1 1 -1 0 1 -1 } { 0 0 1 -1 0 1 } { 0 0 0 1 -1 0 } }",
 			"{ { 0 -1 0 1 0 0 } { 1 0 -1 0 0 0 } { 0 1 0 -1 1 0 } { -1 0 1 0 0 -1 } { 0 0 -1 0 0 1 } { 0 0 0 1 -1 0 } }",
 			{ 0, 4 }, {Line(), Line()},
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 -1 0 1 0 0 } { 1 0 0 0 0 0 } { 0 0 0 0 0 0 } { -1 0 0 0 0 -1 } { 0 0 0 0 0 1 } { 0 0 0 1 -1 0 } }")),
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 -1 0 1 0 0 } { 1 0 0 -1 0 0 } { 0 0 0 0 0 0 } { -1 1 0 0 1 -1 } { 0 0 0 -1 0 1 } { 0 0 0 1 -1 0 } }")) ),
+			finite("{ { 0 -1 0 1 0 0 } { 1 0 0 0 0 0 } { 0 0 0 0 0 0 } { -1 0 0 0 0 -1 } { 0 0 0 0 0 1 } { 0 0 0 1 -1 0 } }"),
+			finite("{ { 0 -1 0 1 0 0 } { 1 0 0 -1 0 0 } { 0 0 0 0 0 0 } { -1 1 0 0 1 -1 } { 0 0 0 -1 0 1 } { 0 0 0 1 -1 0 } }") ),
 	make_move(/*Transpose*/
 			"{ { 0 1 0 -1 0 0 } { -1 0 -1 1 0 0 } { 0 1 0 -1 1 0 } { 1 -1 1 0 -1 1 } { 0 0 -1 1 0 -1 } { 0 0 0 -1 1 0 } }",
 			"{ { 0 1 0 -1 0 0 } { -1 0 1 0 0 0 } { 0 -1 0 1 -1 0 } { 1 0 -1 0 0 1 } { 0 0 1 0 0 -1 } { 0 0 0 -1 1 0 } }",
 			{ 0, 4 }, {Line(), Line()},
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 1 0 -1 0 0 } { -1 0 0 0 0 0 } { 0 0 0 0 0 0 } { 1 0 0 0 0 1 } { 0 0 0 0 0 -1 } { 0 0 0 -1 1 0 } }")),
-			FinReq(cluster::EquivQuiverMatrix("{ { 0 1 0 -1 0 0 } { -1 0 0 1 0 0 } { 0 0 0 0 0 0 } { 1 -1 0 0 -1 1 } { 0 0 0 1 0 -1 } { 0 0 0 -1 1 0 } }")) ),
+			finite("{ { 0 1 0 -1 0 0 } { -1 0 0 0 0 0 } { 0 0 0 0 0 0 } { 1 0 0 0 0 1 } { 0 0 0 0 0 -1 } { 0 0 0 -1 1 0 } }"),
+			finite("{ { 0 1 0 -1 0 0 } { -1 0 0 1 0 0 } { 0 0 0 0 0 0 } { 1 -1 0 0 -1 1 } { 0 0 0 1 0 -1 } { 0 0 0 -1 1 0 } }") ),
 	make_move(
 			"{ { 0 1 -1 0 0 0 0 } { -1 0 1 -1 0 1 0 } { 1 -1 0 1 0 0 0 } { 0 1 -1 0 1 -1 0 } { 0 0 0 -1 0 1 0 } { 0 -1 0 1 -1 0 -1 } { 0 0 0 0 0 1 0 } }",
 			"{ { 0 -1 0 0 0 1 0 } { 1 0 -1 1 0 -1 0 } { 0 1 0 0 0 0 0 } { 0 -1 0 0 1 0 0 } { 0 0 0 -1 0 1 0 } { -1 1 0 0 -1 0 -1 } { 0 0 0 0 0 1 0 } }",
@@ -0,0 +1,91 @@
+/**
+ * dedupe_cache.cc
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "dedupe_cache.h"
+
+#include <cstdlib>
+#include <string>
+
+#include <unistd.h>
+
+namespace qvmove {
+
+DedupeCache::DedupeCache(std::size_t limit)
+	: limit_(limit),
+		memory_(),
+		spilled_() {}
+
+bool DedupeCache::find(const MatrixPtr& m, Result& result) const {
+	auto it = memory_.find(m);
+	if(it != memory_.end()) {
+		result = it->second;
+		return true;
+	}
+	for(auto& table : spilled_) {
+		if(table->find(*m, result)) {
+			return true;
+		}
+	}
+	return false;
+}
+void DedupeCache::insert(const MatrixPtr& m, const Result& result) {
+	memory_[m] = result;
+	if(memory_.size() > limit_) {
+		spill();
+	}
+}
+void DedupeCache::spill() {
+	for(auto& entry : memory_) {
+		/* The tables do not record whether a result is exact, so results which
+		 * might not be are dropped rather than spilled, as are those for matrices
+		 * the tables cannot hold. Any other failed insert means the table is
+		 * full. */
+		if(!entry.second.exact() || !SharedIndex::storable(*entry.first)) {
+			continue;
+		}
+		while(spilled_.empty() || !spilled_.back()->insert(*entry.first,
+					entry.second)) {
+			std::uint64_t capacity = (4 * static_cast<std::uint64_t>(limit_) + 64)
+				<< spilled_.size();
+			if(!add_table(capacity)) {
+				/* Out of disk space, so forget the rest. */
+				memory_.clear();
+				return;
+			}
+		}
+	}
+	memory_.clear();
+}
+bool DedupeCache::add_table(std::uint64_t capacity) {
+	const char* dir = std::getenv("TMPDIR");
+	std::string path = std::string(dir ? dir : "/tmp") + "/qvmove.XXXXXX";
+	int fd = mkstemp(&path[0]);
+	if(fd == -1) {
+		return false;
+	}
+	close(fd);
+	/* mkstemp leaves an empty file, which SharedIndex initialises. */
+	IndexPtr table(new SharedIndex(path, 0, capacity));
+	/* The mapping outlives the name, so the file is removed when we exit. */
+	unlink(path.c_str());
+	if(!table->is_open()) {
+		return false;
+	}
+	spilled_.push_back(std::move(table));
+	return true;
+}
+
+}
@@ -23,6 +23,7 @@
  */
 #include <unistd.h>
 
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -30,15 +31,47 @@
 #include "checker_builder.h"
 #include "consts.h"
 
+/**
+ * Parse a number of bytes, optionally followed by K, M or G.
+ */
+std::size_t bytes(const char* arg) {
+	char* end;
+	std::size_t result = std::strtoul(arg, &end, 10);
+	switch(*end) {
+		case 'G':
+		case 'g':
+			result *= 1024;
+			/* Fall through */
+		case 'M':
+		case 'm':
+			result *= 1024;
+			/* Fall through */
+		case 'K':
+		case 'k':
+			result *= 1024;
+	}
+	return result;
+}
+
 void usage() {
-	std::cout << "qvmove [-i input] [-o output]" << std::endl;
+	std::cout << "qvmove [-i input] [-o output] [-c index] [-p] [-t threads] "
+		"[-a [-x]] [-d limit] [-P seconds] [-M metrics] [-b budget]" << std::endl;
 }
 
 int main(int argc, char *argv[]) {
 	std::string ifile;
 	std::string ofile;
+	std::string index;
+	bool paths = false;
+	int threads = 1;
+	bool best_first = false;
+	bool exact = false;
+	long dedupe = 0;
+	int interval = 0;
+	std::string metrics;
+	std::size_t budget = 0;
 	int c;
-	while ((c = getopt (argc, argv, "i:o:")) != -1) {
+	while ((c = getopt (argc, argv, "i:o:c:pt:axd:P:M:b:")) != -1) {
 		switch (c){
 			case 'i':
 				ifile = optarg;
@@ -46,6 +79,33 @@ int main(int argc, char *argv[]) {
 			case 'o':
 				ofile = optarg;
 				break;
+			case 'c':
+				index = optarg;
+				break;
+			case 'p':
+				paths = true;
+				break;
+			case 't':
+				threads = std::atoi(optarg);
+				break;
+			case 'a':
+				best_first = true;
+				break;
+			case 'x':
+				exact = true;
+				break;
+			case 'd':
+				dedupe = std::atol(optarg);
+				break;
+			case 'P':
+				interval = std::atoi(optarg);
+				break;
+			case 'M':
+				metrics = optarg;
+				break;
+			case 'b':
+				budget = bytes(optarg);
+				break;
 			case '?':
 				usage();
 				return 1;
@@ -57,6 +117,13 @@ int main(int argc, char *argv[]) {
 	qvmove::CheckerBuilder builder;
 	builder.input(ifile);
 	builder.output(ofile);
+	builder.index(index);
+	builder.paths(paths);
+	builder.threads(threads);
+	builder.best_first(best_first, exact);
+	builder.dedupe(dedupe > 0 ? dedupe : 0);
+	builder.progress(interval, metrics);
+	builder.budget(budget);
 
 	qvmove::Checker check(builder.build());
 
@@ -0,0 +1,67 @@
+/**
+ * move_expander.cc
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "move_expander.h"
+
+#include <algorithm>
+
+namespace qvmove {
+
+MoveExpander::MoveExpander(const std::vector<MovePtr>& moves)
+	: moves_(moves) {}
+
+void MoveExpander::operator()(const Matrix& m, const Callback& f) const {
+	int size = m.num_rows();
+	for(std::size_t i = 0; i < moves_.size(); ++i) {
+		auto apps = moves_[i]->applicable_submatrices(m);
+		for(auto& app : apps) {
+			MatrixPtr result = std::make_shared<Matrix>(size, size);
+			moves_[i]->move(app, *result);
+			f(result, static_cast<int>(i));
+		}
+	}
+	for(int k = 0; k < size; ++k) {
+		if(is_sink_source(m, k)) {
+			MatrixPtr result = std::make_shared<Matrix>(size, size);
+			m.mutate(k, *result);
+			f(result, SinkSource);
+		}
+	}
+}
+bool MoveExpander::is_sink_source(const Matrix& m, int k) {
+	bool out = false;
+	bool in = false;
+	for(int j = 0; j < m.num_cols(); ++j) {
+		int v = m.get(k, j);
+		out = out || v > 0;
+		in = in || v < 0;
+	}
+	/* An isolated vertex is both a sink and a source, but mutating at it does
+	 * nothing so it is skipped. */
+	return out != in;
+}
+std::size_t MoveExpander::matrix_memory(int size) {
+	/* The matrix shares its block with the shared_ptr control block, and its
+	 * entries are held separately. */
+	return allocated(sizeof(Matrix) + 2 * sizeof(void*))
+		+ allocated(size * size * sizeof(int));
+}
+std::size_t MoveExpander::allocated(std::size_t bytes) {
+	return std::max<std::size_t>(32,
+			(bytes + sizeof(std::size_t) + 15) & ~std::size_t(15));
+}
+
+}
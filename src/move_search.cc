@@ -0,0 +1,130 @@
+/**
+ * move_search.cc
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "move_search.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace qvmove {
+
+MoveSearch::MoveSearch(const MatrixPtr& initial,
+		const std::vector<MovePtr>& moves)
+	: expander_(moves),
+		nodes_(),
+		seen_(),
+		next_(0),
+		listener_(),
+		/* The matrix and its entries, and a node in seen_ which also holds the hash
+		 * of its key. */
+		matrix_bytes_(MoveExpander::matrix_memory(initial->num_rows())
+				+ MoveExpander::allocated(sizeof(void*)
+					+ sizeof(std::pair<const MatrixPtr, Index>) + sizeof(std::size_t))),
+		limit_(std::numeric_limits<std::size_t>::max()),
+		full_(false) {
+	nodes_.push_back({ initial, Depth(), 0, MoveExpander::SinkSource });
+	seen_.emplace(initial, 0);
+}
+bool MoveSearch::has_next() const {
+	return next_ < nodes_.size();
+}
+MoveSearch::MatrixPtr MoveSearch::next() {
+	Index parent = next_++;
+	/* nodes_ may be reallocated while expanding, so take copies. */
+	MatrixPtr result = nodes_[parent].matrix_;
+	Depth depth = nodes_[parent].depth_;
+	expander_(*result, [&](const MatrixPtr& m, int move) {
+		Index child = static_cast<Index>(nodes_.size());
+		if(nodes_.size() == limit_) {
+			/* Adding another matrix would grow nodes_ or seen_. */
+			auto it = seen_.find(m);
+			if(it == seen_.end()) {
+				full_ = true;
+				return;
+			}
+			child = it->second;
+			if(listener_) {
+				listener_({ parent, child, move });
+			}
+			return;
+		}
+		auto ins = seen_.emplace(m, child);
+		if(ins.second) {
+			if(move == MoveExpander::SinkSource) {
+				nodes_.push_back({ m, Depth(depth.moves_, depth.sinksource_ + 1),
+						parent, move });
+			} else {
+				nodes_.push_back({ m, Depth(depth.moves_ + 1, depth.sinksource_),
+						parent, move });
+			}
+		} else {
+			child = ins.first->second;
+		}
+		if(listener_) {
+			listener_({ parent, child, move });
+		}
+	});
+	return result;
+}
+MoveSearch::Depth MoveSearch::depth() const {
+	return nodes_[next_ - 1].depth_;
+}
+MoveSearch::Index MoveSearch::index() const {
+	return next_ - 1;
+}
+std::size_t MoveSearch::size() const {
+	return nodes_.size();
+}
+std::size_t MoveSearch::remaining() const {
+	return nodes_.size() - next_;
+}
+std::size_t MoveSearch::memory() const {
+	return MoveExpander::allocated(nodes_.capacity() * sizeof(Node))
+		+ MoveExpander::allocated(seen_.bucket_count() * sizeof(void*))
+		+ nodes_.size() * matrix_bytes_;
+}
+void MoveSearch::limit_memory(std::size_t bytes) {
+	/* Allow twice as many buckets as matrices, as seen_ rounds the number of
+	 * buckets up. */
+	std::size_t each = sizeof(Node) + 2 * sizeof(void*) + matrix_bytes_;
+	std::size_t count = std::max(nodes_.size(), bytes / each);
+	nodes_.reserve(count);
+	seen_.reserve(count);
+	/* Then only use the room which is left once the buckets are known. */
+	std::size_t used = memory();
+	std::size_t room = used < bytes ? (bytes - used) / matrix_bytes_ : 0;
+	limit_ = std::min(count, nodes_.size() + room);
+}
+bool MoveSearch::full() const {
+	return full_;
+}
+void MoveSearch::edge_listener(const EdgeListener& listener) {
+	listener_ = listener;
+}
+const MoveSearch::MatrixPtr& MoveSearch::matrix(Index index) const {
+	return nodes_[index].matrix_;
+}
+std::vector<MoveSearch::Edge> MoveSearch::path(Index index) const {
+	std::vector<Edge> result;
+	while(index != 0) {
+		const Node& node = nodes_[index];
+		result.push_back({ node.parent_, index, node.move_ });
+		index = node.parent_;
+	}
+	return std::vector<Edge>(result.rbegin(), result.rend());
+}
+
+}
@@ -0,0 +1,263 @@
+/**
+ * parallel_search.cc
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "parallel_search.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
+namespace qvmove {
+
+ParallelSearch::ParallelSearch(WorkPool& pool,
+		const std::vector<MovePtr>& moves, const TargetSet& targets)
+	: pool_(pool),
+		expander_(moves),
+		targets_(targets),
+		progress_(nullptr) {}
+
+Result ParallelSearch::run(const MatrixPtr& init) const {
+	if(targets_(init)) {
+		return Result(0, 0);
+	}
+	State state;
+	start(init, state);
+	while(!state.empty()) {
+		Best best;
+		step(state, &best);
+		if(best.result_.found_) {
+			return best.result_;
+		}
+	}
+	return Result();
+}
+void ParallelSearch::enumerate(const MatrixPtr& init,
+		const Visitor& visit) const {
+	State state;
+	start(init, state);
+	if(!visit(init)) {
+		return;
+	}
+	while(!state.empty()) {
+		step(state, nullptr);
+		for(auto& part : state.frontier_) {
+			for(auto& node : part) {
+				if(!visit(node.matrix_)) {
+					return;
+				}
+			}
+		}
+	}
+}
+void ParallelSearch::start(const MatrixPtr& init, State& state) const {
+	std::size_t shard = init->hash() % Shards;
+	state.seen_[shard].insert(init);
+	state.frontier_[shard].push_back({ init, Depth(), 0, 0 });
+}
+void ParallelSearch::step(State& state, Best* best) const {
+	struct Chunk {
+		const Node* begin_;
+		const Node* end_;
+		int owner_;
+	};
+	std::vector<Chunk> chunks;
+	for(std::size_t shard = 0; shard < Shards; ++shard) {
+		const Frontier& part = state.frontier_[shard];
+		for(std::size_t i = 0; i < part.size(); i += ChunkSize) {
+			chunks.push_back({ part.data() + i,
+					part.data() + std::min(part.size(), i + ChunkSize), owner(shard) });
+		}
+	}
+	std::vector<Frontier> next(Shards);
+	std::vector<Level> level(Shards);
+	std::vector<Found> found;
+	for(std::size_t first = 0; first < chunks.size(); first += BatchSize) {
+		/* Expand each chunk of the batch, preferably on the node which owns it. */
+		std::size_t last = std::min(chunks.size(), first + BatchSize);
+		found.assign(last - first, Found());
+		WorkPool::Group expanding;
+		for(std::size_t i = first; i < last; ++i) {
+			const Chunk& chunk = chunks[i];
+			Found* out = &found[i - first];
+			pool_.submit(expanding, [this, chunk, out]() {
+					expand(chunk.begin_, chunk.end_, *out);
+				}, chunk.owner_);
+		}
+		pool_.wait(expanding);
+		/* Then merge what was found into each shard, only ever on its own node.
+		 * Once the whole level is merged, each shard puts its share of the next
+		 * frontier in breadth first order. */
+		bool done = last == chunks.size();
+		WorkPool::Group merging;
+		for(std::size_t shard = 0; shard < Shards; ++shard) {
+			Frontier* out = &next[shard];
+			Level* positions = &level[shard];
+			pool_.submit(merging,
+					[this, shard, &found, &state, out, positions, done, best]() {
+						merge(shard, found, state, *positions, *out);
+						if(done) {
+							Level().swap(*positions);
+							finish(*out, best);
+						}
+					}, owner(shard), true);
+		}
+		pool_.wait(merging);
+	}
+	/* Only the search for a target needs the breadth first order. */
+	if(best != nullptr) {
+		renumber(next);
+	}
+	state.frontier_.swap(next);
+	if(progress_) {
+		progress_->search(state.frontier_size(), state.seen_size());
+	}
+}
+void ParallelSearch::progress(Progress* progress) {
+	progress_ = progress;
+}
+void ParallelSearch::expand(const Node* begin, const Node* end,
+		Found& found) const {
+	found.resize(Shards);
+	for(const Node* node = begin; node != end; ++node) {
+		const Depth& depth = node->depth_;
+		std::uint32_t child = 0;
+		expander_(*node->matrix_, [&](const MatrixPtr& m, int move) {
+			Depth d = move == MoveExpander::SinkSource
+				? Depth(depth.moves_, depth.sinksource_ + 1)
+				: Depth(depth.moves_ + 1, depth.sinksource_);
+			found[m->hash() % Shards].push_back({ m, d, node->order_, child++ });
+		});
+	}
+}
+void ParallelSearch::merge(std::size_t shard, std::vector<Found>& found,
+		State& state, Level& level, Frontier& next) const {
+	std::unordered_set<MatrixPtr>& seen = state.seen_[shard];
+	bool copy = pool_.nodes() > 1;
+	for(auto& chunk : found) {
+		if(chunk.empty()) {
+			continue;
+		}
+		for(auto& node : chunk[shard]) {
+			auto prev = level.find(node.matrix_);
+			if(prev != level.end()) {
+				/* Keep whichever would be found first. Its labelling may differ, which
+				 * changes the order its own neighbours are found in. */
+				Node& old = next[prev->second];
+				if(before(node, old)) {
+					std::size_t position = prev->second;
+					seen.erase(old.matrix_);
+					level.erase(prev);
+					old = std::move(node);
+					if(copy) {
+						old.matrix_ = std::make_shared<Matrix>(*old.matrix_);
+					}
+					seen.insert(old.matrix_);
+					level.emplace(old.matrix_, position);
+				}
+				continue;
+			}
+			if(seen.count(node.matrix_) > 0) {
+				continue;
+			}
+			if(copy) {
+				/* The matrix was made on the node which expanded its parent, so keep a
+				 * copy made here on the shard's own node instead. */
+				node.matrix_ = std::make_shared<Matrix>(*node.matrix_);
+			}
+			seen.insert(node.matrix_);
+			level.emplace(node.matrix_, next.size());
+			next.push_back(std::move(node));
+		}
+		/* Release the matrices which were already seen as soon as possible. */
+		Frontier().swap(chunk[shard]);
+	}
+}
+void ParallelSearch::finish(Frontier& next, Best* best) const {
+	/* Only the search for a target needs the breadth first order. */
+	if(best == nullptr) {
+		return;
+	}
+	std::sort(next.begin(), next.end(), before);
+	for(auto& node : next) {
+		if(targets_(node.matrix_)) {
+			best->offer(node);
+			break;
+		}
+	}
+}
+void ParallelSearch::renumber(std::vector<Frontier>& frontier) {
+	/* Each part is already sorted, so merging them gives the order of the whole
+	 * level. */
+	typedef std::pair<std::pair<std::uint64_t, std::uint32_t>, std::size_t> Head;
+	std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+	std::vector<std::size_t> pos(frontier.size(), 0);
+	for(std::size_t shard = 0; shard < frontier.size(); ++shard) {
+		if(!frontier[shard].empty()) {
+			const Node& node = frontier[shard].front();
+			heads.push({ { node.order_, node.child_ }, shard });
+		}
+	}
+	std::uint64_t order = 0;
+	while(!heads.empty()) {
+		std::size_t shard = heads.top().second;
+		heads.pop();
+		Node& node = frontier[shard][pos[shard]++];
+		node.order_ = order++;
+		node.child_ = 0;
+		if(pos[shard] < frontier[shard].size()) {
+			const Node& next = frontier[shard][pos[shard]];
+			heads.push({ { next.order_, next.child_ }, shard });
+		}
+	}
+}
+bool ParallelSearch::before(const Node& a, const Node& b) {
+	return a.order_ < b.order_ || (a.order_ == b.order_ && a.child_ < b.child_);
+}
+int ParallelSearch::owner(std::size_t shard) const {
+	return static_cast<int>(shard % pool_.nodes());
+}
+bool ParallelSearch::State::empty() const {
+	for(auto& part : frontier_) {
+		if(!part.empty()) {
+			return false;
+		}
+	}
+	return true;
+}
+std::size_t ParallelSearch::State::frontier_size() const {
+	std::size_t result = 0;
+	for(auto& part : frontier_) {
+		result += part.size();
+	}
+	return result;
+}
+std::size_t ParallelSearch::State::seen_size() const {
+	std::size_t result = 0;
+	for(auto& shard : seen_) {
+		result += shard.size();
+	}
+	return result;
+}
+void ParallelSearch::Best::offer(const Node& node) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if(!result_.found_ || before(node, node_)) {
+		result_ = Result(node.depth_.moves_, node.depth_.sinksource_);
+		node_ = node;
+	}
+}
+
+}
@@ -0,0 +1,111 @@
+/**
+ * progress.cc
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "progress.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+namespace qvmove {
+
+Progress::Progress(const std::string& name, int interval,
+		const std::string& metrics)
+	: name_(name),
+		/* Metrics are still refreshed every second if no interval is given. */
+		interval_(interval > 0 ? interval : 1),
+		stderr_(interval > 0),
+		metrics_(metrics),
+		start_(Clock::now()),
+		inputs_(0),
+		frontier_(0),
+		visited_(0),
+		mutex_(),
+		wake_(),
+		stop_(false),
+		thread_(&Progress::work, this) {}
+
+Progress::~Progress() {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	wake_.notify_all();
+	thread_.join();
+	report();
+}
+void Progress::input_done() {
+	inputs_.fetch_add(1, std::memory_order_relaxed);
+}
+void Progress::search(std::size_t frontier, std::size_t visited) {
+	frontier_.store(frontier, std::memory_order_relaxed);
+	visited_.store(visited, std::memory_order_relaxed);
+}
+void Progress::work() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	while(!wake_.wait_for(lock, interval_, [this]() { return stop_; })) {
+		report();
+	}
+}
+void Progress::report() {
+	double seconds = std::chrono::duration<double>(Clock::now() - start_).count();
+	std::uint64_t inputs = inputs_.load(std::memory_order_relaxed);
+	double rate = seconds > 0 ? inputs / seconds : 0;
+	std::uint64_t frontier = frontier_.load(std::memory_order_relaxed);
+	std::uint64_t visited = visited_.load(std::memory_order_relaxed);
+	std::uint64_t memory = rss();
+	if(stderr_) {
+		std::cerr << name_ << ": " << inputs << " inputs, " << rate
+			<< " inputs/s, frontier " << frontier << ", visited " << visited
+			<< ", rss " << memory / (1024 * 1024) << "MB" << std::endl;
+	}
+	if(metrics_.empty()) {
+		return;
+	}
+	std::string tmp = metrics_ + ".tmp";
+	{
+		std::ofstream out(tmp);
+		if(!out.is_open()) {
+			return;
+		}
+		out << "# TYPE " << name_ << "_inputs_done counter\n"
+			<< name_ << "_inputs_done " << inputs << "\n"
+			<< "# TYPE " << name_ << "_inputs_per_second gauge\n"
+			<< name_ << "_inputs_per_second " << rate << "\n"
+			<< "# TYPE " << name_ << "_frontier_size gauge\n"
+			<< name_ << "_frontier_size " << frontier << "\n"
+			<< "# TYPE " << name_ << "_visited_size gauge\n"
+			<< name_ << "_visited_size " << visited << "\n"
+			<< "# TYPE " << name_ << "_rss_bytes gauge\n"
+			<< name_ << "_rss_bytes " << memory << "\n"
+			<< "# TYPE " << name_ << "_uptime_seconds gauge\n"
+			<< name_ << "_uptime_seconds " << seconds << "\n";
+	}
+	std::rename(tmp.c_str(), metrics_.c_str());
+}
+std::uint64_t Progress::rss() {
+	std::ifstream statm("/proc/self/statm");
+	std::uint64_t size = 0;
+	std::uint64_t resident = 0;
+	if(!(statm >> size >> resident)) {
+		return 0;
+	}
+	return resident * static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+}
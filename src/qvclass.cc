@@ -0,0 +1,192 @@
+/**
+ * qvclass.cc
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * Program to query and combine the sorted class files written by qvmovecl.
+ */
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "qv/stream_iterator.h"
+
+#include "canonical_form.h"
+#include "class_file.h"
+
+namespace {
+typedef cluster::EquivQuiverMatrix Matrix;
+typedef std::unique_ptr<qvmove::ClassReader> ReaderPtr;
+
+enum class Command { List, Contains, Merge };
+
+int read_error(const std::string& path) {
+	std::cerr << "Error reading class file " << path << std::endl;
+	return 2;
+}
+
+/** Check whether the two paths name the same existing file. */
+bool same_file(const std::string& a, const std::string& b) {
+	struct stat sa;
+	struct stat sb;
+	return stat(a.c_str(), &sa) == 0 && stat(b.c_str(), &sb) == 0
+		&& sa.st_dev == sb.st_dev && sa.st_ino == sb.st_ino;
+}
+
+/**
+ * Print every matrix in the file.
+ */
+int list(qvmove::ClassReader& reader, const std::string& path) {
+	while(reader.has_next()) {
+		std::cout << *qvmove::CanonicalForm::matrix(reader.next())
+			<< std::cout.widen('\n');
+	}
+	std::cout.flush();
+	return reader.failed() ? read_error(path) : 0;
+}
+
+/**
+ * Check whether each matrix in the input is in the file. Returns 3 if any is
+ * not.
+ */
+int contains(qvmove::ClassReader& reader, const std::string& path,
+		std::istream& input) {
+	cluster::StreamIterator<Matrix> iter(input);
+	bool all = true;
+	while(iter.has_next()) {
+		auto matrix = iter.next();
+		std::string key = qvmove::CanonicalForm::key(*matrix);
+		bool found = !key.empty() && reader.contains(key);
+		if(reader.failed()) {
+			return read_error(path);
+		}
+		std::cout << (found ? "Yes" : "No") << ": " << *matrix << std::endl;
+		all = all && found;
+	}
+	return all ? 0 : 3;
+}
+}
+
+void usage() {
+	std::cout << "qvclass [-l | -c [-i input] | -u | -n | -d] [-o output] "
+		"file..." << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+	Command command = Command::List;
+	qvmove::class_file::Operation operation =
+		qvmove::class_file::Operation::Union;
+	std::string ifile;
+	std::string ofile;
+	int c;
+	while ((c = getopt (argc, argv, "lci:undo:")) != -1) {
+		switch (c){
+			case 'l':
+				command = Command::List;
+				break;
+			case 'c':
+				command = Command::Contains;
+				break;
+			case 'i':
+				ifile = optarg;
+				break;
+			case 'u':
+				command = Command::Merge;
+				operation = qvmove::class_file::Operation::Union;
+				break;
+			case 'n':
+				command = Command::Merge;
+				operation = qvmove::class_file::Operation::Intersect;
+				break;
+			case 'd':
+				command = Command::Merge;
+				operation = qvmove::class_file::Operation::Difference;
+				break;
+			case 'o':
+				ofile = optarg;
+				break;
+			case '?':
+				usage();
+				return 1;
+			default:
+				usage();
+				return 2;
+		}
+	}
+	bool single = command == Command::List || command == Command::Contains;
+	int files = argc - optind;
+	if(files < 1 || (single && files != 1) || (!single && ofile.empty())) {
+		usage();
+		return 1;
+	}
+	std::vector<std::string> paths(argv + optind, argv + argc);
+	std::vector<ReaderPtr> readers;
+	for(auto& path : paths) {
+		readers.emplace_back(new qvmove::ClassReader(path));
+		if(!readers.back()->is_open()) {
+			return read_error(path);
+		}
+	}
+	if(command == Command::List) {
+		return list(*readers.front(), paths.front());
+	}
+	if(command == Command::Contains) {
+		if(ifile.empty()) {
+			return contains(*readers.front(), paths.front(), std::cin);
+		}
+		std::ifstream input(ifile);
+		if(!input.is_open()) {
+			std::cerr << "Error opening file " << ifile << std::endl;
+			return 2;
+		}
+		return contains(*readers.front(), paths.front(), input);
+	}
+	/* Opening the output empties it, so it must not be one of the inputs. */
+	for(auto& path : paths) {
+		if(same_file(path, ofile)) {
+			std::cerr << "Output file " << ofile << " is also an input"
+				<< std::endl;
+			return 2;
+		}
+	}
+	qvmove::ClassWriter writer(ofile);
+	if(!writer.is_open()) {
+		std::cerr << "Error opening file " << ofile << std::endl;
+		return 2;
+	}
+	std::vector<qvmove::ClassReader*> inputs;
+	for(auto& reader : readers) {
+		inputs.push_back(reader.get());
+	}
+	qvmove::class_file::merge(inputs, operation, writer);
+	for(std::size_t i = 0; i < readers.size(); ++i) {
+		if(readers[i]->failed()) {
+			/* Do not leave behind a file missing some of the keys. */
+			writer.close();
+			std::remove(ofile.c_str());
+			return read_error(paths[i]);
+		}
+	}
+	if(!writer.close()) {
+		std::cerr << "Error writing file " << ofile << std::endl;
+		return 2;
+	}
+	return 0;
+}
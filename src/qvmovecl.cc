@@ -19,26 +19,290 @@
  */
 #include <unistd.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <string>
 
+#include "qv/equiv_underlying_graph.h"
 #include "qv/move_class_loader.h"
 
+#include "canonical_form.h"
+#include "class_file.h"
 #include "consts.h"
+#include "move_search.h"
+#include "parallel_search.h"
+#include "progress.h"
+
+namespace {
+typedef cluster::EquivQuiverMatrix Matrix;
+typedef std::shared_ptr<Matrix> MatrixPtr;
+typedef cluster::EquivUnderlyingGraph Graph;
+typedef std::shared_ptr<Graph> GraphPtr;
+
+/**
+ * Decides which matrices in the class should be output. If no conditions are
+ * set then every matrix matches, otherwise a matrix matches if it satisfies
+ * all the conditions which are set.
+ */
+class Filter {
+	public:
+		Filter()
+			: size_(-1),
+				reps_(false),
+				graph_(),
+				tmp_graph_(std::make_shared<Graph>(cluster::IntMatrix())) {}
+		void size(int size) {
+			size_ = size;
+		}
+		/**
+		 * Check whether no matrix in the class of m can match. Moves and mutations
+		 * never change the number of rows, so this is the case if it differs from
+		 * the size asked for.
+		 */
+		bool excludes(const Matrix& m) const {
+			return size_ >= 0 && m.num_rows() != size_;
+		}
+		void reps() {
+			reps_ = true;
+		}
+		void graph(const std::string& matrix) {
+			graph_ = std::make_shared<Graph>(cluster::IntMatrix(matrix));
+		}
+		bool empty() const {
+			return size_ < 0 && !reps_ && !graph_;
+		}
+		bool operator()(const MatrixPtr& matrix) {
+			if(size_ >= 0 && matrix->num_rows() != size_) {
+				return false;
+			}
+			if(reps_ &&
+					qvmove::consts::Reps.find(matrix) == qvmove::consts::Reps.end()) {
+				return false;
+			}
+			if(graph_) {
+				tmp_graph_->set_matrix(*matrix);
+				if(!graph_->equals(*tmp_graph_)) {
+					return false;
+				}
+			}
+			return true;
+		}
+	private:
+		int size_;
+		bool reps_;
+		GraphPtr graph_;
+		GraphPtr tmp_graph_;
+};
+
+/**
+ * Writes the edges of a move class to a binary file. The file starts with an
+ * 8 byte magic string, followed by one record per edge of three 32 bit
+ * integers: the parent index, the child index and the move index (-1 for a
+ * sink-source mutation). Matrix indices are the positions of the matrices in
+ * the output of qvmovecl.
+ */
+class EdgeWriter {
+	public:
+		EdgeWriter(const std::string& file)
+			: out_(file, std::ios::binary) {
+			out_.write("QVEDGES1", 8);
+		}
+		bool is_open() const {
+			return out_.is_open();
+		}
+		void operator()(const qvmove::MoveSearch::Edge& edge) {
+			std::int32_t record[3] = { static_cast<std::int32_t>(edge.parent_),
+				static_cast<std::int32_t>(edge.child_), edge.move_ };
+			out_.write(reinterpret_cast<const char*>(record), sizeof(record));
+		}
+	private:
+		std::ofstream out_;
+};
+
+/**
+ * Receives the matching matrices. Each one is either written straight to
+ * stdout, or its canonical key is kept so that all of them can be written to a
+ * sorted class file once the class is complete.
+ */
+class Output {
+	public:
+		Output()
+			: stream_(false),
+				writer_(),
+				path_(),
+				keys_(),
+				too_large_(false) {}
+		/**
+		 * Flush stdout after every matrix, so each is seen as soon as it is found.
+		 */
+		void stream(bool stream) {
+			stream_ = stream;
+		}
+		/** Write to the given class file instead of stdout. */
+		bool class_file(const std::string& file) {
+			path_ = file;
+			writer_.reset(new qvmove::ClassWriter(file));
+			return writer_->is_open();
+		}
+		/**
+		 * Write out the matrix. Returns false if it has entries too large to be
+		 * written to the class file, after which nothing more is written.
+		 */
+		bool operator()(const MatrixPtr& matrix) {
+			if(writer_) {
+				std::string key = qvmove::CanonicalForm::key(*matrix);
+				if(key.empty()) {
+					too_large_ = true;
+					return false;
+				}
+				keys_.push_back(std::move(key));
+			} else {
+				std::cout << *matrix << std::cout.widen('\n');
+				if(stream_) {
+					std::cout.flush();
+				}
+			}
+			return true;
+		}
+		/** Check whether a matrix could not be written to the class file. */
+		bool too_large() const {
+			return too_large_;
+		}
+		/**
+		 * Finish writing the output. Returns false if this failed, in which case
+		 * no class file is left behind.
+		 */
+		bool finish() {
+			if(!writer_) {
+				std::cout.flush();
+				return true;
+			}
+			if(too_large_) {
+				writer_.reset();
+				std::remove(path_.c_str());
+				return false;
+			}
+			std::sort(keys_.begin(), keys_.end());
+			for(auto& key : keys_) {
+				writer_->add(key);
+			}
+			return writer_->close();
+		}
+	private:
+		bool stream_;
+		std::unique_ptr<qvmove::ClassWriter> writer_;
+		std::string path_;
+		std::vector<std::string> keys_;
+		bool too_large_;
+};
+
+/** Report the size of the search, where the loader makes that available. */
+void report(qvmove::Progress* progress, const qvmove::MoveSearch& search) {
+	if(progress) {
+		progress->search(search.remaining(), search.size());
+	}
+}
+void report(qvmove::Progress*, const cluster::MoveClassLoader&) {}
+
+/**
+ * Write out the matrices from the loader which match the filter, stopping after
+ * limit matches if limit is not negative. Returns the number of matches.
+ */
+template<class Loader>
+long enumerate(Loader& loader, Filter& filter, long limit,
+		qvmove::Progress* progress, Output& output) {
+	long found = 0;
+	while((limit < 0 || found < limit) && loader.has_next()){
+		auto matrix = loader.next();
+		report(progress, loader);
+		if(filter(matrix)) {
+			if(!output(matrix)) {
+				break;
+			}
+			++found;
+		}
+	}
+	return found;
+}
+
+/**
+ * As enumerate, but computes the class using all threads in the pool.
+ */
+long enumerate_parallel(const MatrixPtr& m, int threads, Filter& filter,
+		long limit, qvmove::Progress* progress, Output& output) {
+	static const std::unordered_set<MatrixPtr> reps;
+	static const std::unordered_set<GraphPtr> graphs;
+	qvmove::WorkPool pool(threads);
+	qvmove::TargetSet targets(reps, graphs);
+	qvmove::ParallelSearch search(pool, qvmove::consts::Moves, targets);
+	search.progress(progress);
+	long found = 0;
+	search.enumerate(m, [&](const MatrixPtr& matrix) {
+		if(limit >= 0 && found >= limit) {
+			return false;
+		}
+		if(filter(matrix)) {
+			if(!output(matrix)) {
+				return false;
+			}
+			++found;
+		}
+		return true;
+	});
+	return found;
+}
+}
 
 void usage() {
-	std::cout << "qvmove -m matrix" << std::endl;
+	std::cout << "qvmovecl -m matrix [-r] [-s size] [-g graph] [-n limit] "
+		"[-e edges] [-t threads] [-P seconds] [-M metrics] [-w file]" << std::endl;
 }
 
 int main(int argc, char *argv[]) {
 	std::string matrix;
+	Filter filter;
+	long limit = -1;
+	std::string edges;
+	int threads = 1;
+	int interval = 0;
+	std::string metrics;
+	std::string class_file;
 	int c;
-	while ((c = getopt (argc, argv, "m:")) != -1) {
+	while ((c = getopt (argc, argv, "m:rs:g:n:e:t:P:M:w:")) != -1) {
 		switch (c){
 			case 'm':
 				matrix = optarg;
 				break;
+			case 'r':
+				filter.reps();
+				break;
+			case 's':
+				filter.size(std::atoi(optarg));
+				break;
+			case 'g':
+				filter.graph(optarg);
+				break;
+			case 'n':
+				limit = std::atol(optarg);
+				break;
+			case 'e':
+				edges = optarg;
+				break;
+			case 't':
+				threads = std::atoi(optarg);
+				break;
+			case 'P':
+				interval = std::atoi(optarg);
+				break;
+			case 'M':
+				metrics = optarg;
+				break;
+			case 'w':
+				class_file = optarg;
+				break;
 			case '?':
 				usage();
 				return 1;
@@ -51,13 +315,71 @@ int main(int argc, char *argv[]) {
 		usage();
 		return 1;
 	}
-	std::shared_ptr<cluster::EquivQuiverMatrix>
-		m = std::make_shared<cluster::EquivQuiverMatrix>(matrix);
-	cluster::MoveClassLoader loader(m, qvmove::consts::Moves);
-	while(loader.has_next()){
-		auto matrix = loader.next();
-		std::cout << *matrix << std::cout.widen('\n');
+	/* The edges refer to positions in the output, so it must hold the whole
+	 * class in the order found by the serial search. */
+	if(!edges.empty() && (!filter.empty() || limit >= 0 || !class_file.empty())) {
+		std::cerr << "Edges can only be written along with the whole class on stdout"
+			<< std::endl;
+		return 2;
+	}
+	if(!edges.empty() && threads > 1) {
+		std::cerr << "Edges cannot be written using threads" << std::endl;
+		return 2;
+	}
+	long found = 0;
+	MatrixPtr m = std::make_shared<Matrix>(matrix);
+	if(filter.excludes(*m)) {
+		return 3;
+	}
+	Output output;
+	/* When looking for particular matrices each one is written out as soon as it
+	 * is found, rather than waiting for the whole class. */
+	output.stream(!filter.empty() || limit >= 0);
+	if(!class_file.empty()) {
+		if(m->num_rows() > qvmove::CanonicalForm::MaxSize) {
+			std::cerr << "Matrix too large to write to a class file" << std::endl;
+			return 2;
+		}
+		if(!output.class_file(class_file)) {
+			std::cerr << "Error opening file " << class_file << std::endl;
+			return 2;
+		}
+	}
+	std::unique_ptr<qvmove::Progress> progress;
+	if(interval > 0 || !metrics.empty()) {
+		progress.reset(new qvmove::Progress("qvmovecl", interval, metrics));
+	}
+	if(edges.empty() && threads > 1) {
+		found = enumerate_parallel(m, threads, filter, limit, progress.get(),
+				output);
+	} else if(edges.empty() && !progress) {
+		cluster::MoveClassLoader loader(m, qvmove::consts::Moves);
+		found = enumerate(loader, filter, limit, nullptr, output);
+	} else {
+		/* MoveSearch is used whenever edges or sizes need to be reported. */
+		std::unique_ptr<EdgeWriter> writer;
+		qvmove::MoveSearch search(m, qvmove::consts::Moves);
+		if(!edges.empty()) {
+			writer.reset(new EdgeWriter(edges));
+			if(!writer->is_open()) {
+				std::cerr << "Error opening file " << edges << std::endl;
+				return 2;
+			}
+			search.edge_listener(std::ref(*writer));
+		}
+		found = enumerate(search, filter, limit, progress.get(), output);
+	}
+	if(!output.finish()) {
+		if(output.too_large()) {
+			std::cerr << "Matrix entries too large to write to a class file"
+				<< std::endl;
+		} else {
+			std::cerr << "Error writing file " << class_file << std::endl;
+		}
+		return 2;
+	}
+	if(!filter.empty() && found == 0) {
+		return 3;
 	}
-	std::cout.flush();
 	return 0;
 }
@@ -0,0 +1,671 @@
+/**
+ * qvmovediff.cc
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * Program to check the search engines used by qvmove and qvmovecl against the
+ * plain MoveClassLoader search. Random quivers are generated by starting at a
+ * representative and taking random steps through its move class, sometimes
+ * followed by a mutation to leave the class. Each engine is run on every quiver,
+ * both with the representatives as targets and with the underlying graphs of
+ * some other random quivers added as targets, and any result which differs from
+ * that of MoveClassLoader is printed.
+ *
+ * The paths found for qvmove -p are checked step by step, and the class of
+ * each quiver is written to class files and read back and merged as qvclass
+ * does. Finally qvmove's Checker is run over all the quivers, along with
+ * relabelled copies of some, with each of the options which change how results
+ * are found or reused. Its output is compared with the result of MoveClassLoader
+ * for each input, or for the canonical labelling of each input when results
+ * are shared. The total time taken by each check is printed at the end.
+ */
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "qv/move_class_loader.h"
+
+#include "best_first_search.h"
+#include "bounded_search.h"
+#include "canonical_form.h"
+#include "checker.h"
+#include "class_file.h"
+#include "consts.h"
+#include "parallel_search.h"
+
+namespace {
+typedef cluster::EquivQuiverMatrix Matrix;
+typedef std::shared_ptr<Matrix> MatrixPtr;
+typedef std::unordered_set<MatrixPtr> MatrixSet;
+typedef cluster::EquivUnderlyingGraph Graph;
+typedef std::shared_ptr<Graph> GraphPtr;
+typedef std::unordered_set<GraphPtr> GraphSet;
+typedef std::chrono::steady_clock Clock;
+typedef std::vector<std::string> Keys;
+
+/** Smallest and largest number of rows of the generated quivers. */
+const int MinSize = 5;
+const int MaxSize = 10;
+/** Number of random quivers whose underlying graphs are used as targets. */
+const int GraphTargets = 16;
+
+/**
+ * Total time spent and number of differences found for each engine.
+ */
+class Tally {
+	public:
+		Tally()
+			: names_(),
+				references_(),
+				times_(),
+				failures_(),
+				start_() {}
+		/**
+		 * Start timing the named engine, whose speed is compared with that of the
+		 * reference engine, or with nothing if the reference is empty.
+		 */
+		void start(const std::string& name, const std::string& reference = "") {
+			if(std::find(names_.begin(), names_.end(), name) == names_.end()) {
+				references_.push_back(reference.empty() ? names_.size()
+						: position(reference));
+				names_.push_back(name);
+				times_.push_back(Clock::duration::zero());
+				failures_.push_back(0);
+			}
+			start_ = Clock::now();
+		}
+		/** Stop timing the named engine. */
+		void stop(const std::string& name) {
+			times_[position(name)] += Clock::now() - start_;
+		}
+		void fail(const std::string& name) {
+			++failures_[position(name)];
+		}
+		long failures() const {
+			long total = 0;
+			for(long f : failures_) {
+				total += f;
+			}
+			return total;
+		}
+		/** Print each engine's time and its speedup over its reference. */
+		void write(std::ostream& out) const {
+			for(std::size_t i = 0; i < names_.size(); ++i) {
+				double secs = std::chrono::duration<double>(times_[i]).count();
+				double ref =
+					std::chrono::duration<double>(times_[references_[i]]).count();
+				out << std::left << std::setw(16) << names_[i] << std::right
+					<< std::fixed << std::setprecision(3) << std::setw(10) << secs << "s"
+					<< std::setw(9) << std::setprecision(2)
+					<< (secs > 0 ? ref / secs : 0) << "x"
+					<< std::setw(8) << failures_[i] << " differences" << std::endl;
+			}
+		}
+	private:
+		std::vector<std::string> names_;
+		std::vector<std::size_t> references_;
+		std::vector<Clock::duration> times_;
+		std::vector<long> failures_;
+		Clock::time_point start_;
+
+		std::size_t position(const std::string& name) const {
+			return std::find(names_.begin(), names_.end(), name) - names_.begin();
+		}
+};
+
+std::ostream& operator<<(std::ostream& out, const qvmove::Result& result) {
+	if(!result.found_) {
+		return out << "None";
+	}
+	return out << result.moves_ << "(" << result.sinksource_ << ")"
+		<< (result.minimal_ ? "" : "?") << (result.degraded_ ? "~" : "");
+}
+
+/**
+ * Check a result against that of the reference search. An exact result must
+ * match it completely, including the split between moves and sink-source
+ * mutations. A result which is not exact may miss a target or find a longer
+ * path, but any path it finds must exist. One which only failed to be first in
+ * breadth first order must still have the same total.
+ */
+bool agrees(const qvmove::Result& ref, const qvmove::Result& result) {
+	int ref_total = ref.moves_ + ref.sinksource_;
+	int total = result.moves_ + result.sinksource_;
+	if(result.exact()) {
+		return ref.found_ == result.found_ && (!ref.found_
+				|| (ref.moves_ == result.moves_ && ref.sinksource_ == result.sinksource_));
+	}
+	if(result.minimal_ && !result.degraded_) {
+		return ref.found_ == result.found_ && (!ref.found_ || ref_total == total);
+	}
+	if(!result.found_) {
+		return result.degraded_ || !ref.found_;
+	}
+	return ref.found_ && total >= ref_total;
+}
+
+/**
+ * Generates random quivers which look like those given to qvmove.
+ */
+class Generator {
+	public:
+		Generator(unsigned seed, int steps)
+			: random_(seed),
+				steps_(steps),
+				reps_(),
+				expander_(qvmove::consts::Moves) {
+			for(auto& rep : qvmove::consts::Reps) {
+				if(rep->num_rows() >= MinSize && rep->num_rows() <= MaxSize) {
+					reps_.push_back(rep);
+				}
+			}
+		}
+		bool empty() const {
+			return reps_.empty();
+		}
+		MatrixPtr operator()() {
+			MatrixPtr matrix = reps_[pick(reps_.size())];
+			std::vector<MatrixPtr> next;
+			for(int i = 0; i < steps_; ++i) {
+				next.clear();
+				expander_(*matrix, [&next](const MatrixPtr& m, int) {
+						next.push_back(m);
+					});
+				if(next.empty()) {
+					break;
+				}
+				matrix = next[pick(next.size())];
+			}
+			/* Sometimes leave the move class, so that the searches also see quivers
+			 * which cannot reach a representative. */
+			if(pick(4) == 0) {
+				MatrixPtr result = std::make_shared<Matrix>(matrix->num_rows(),
+						matrix->num_cols());
+				matrix->mutate(pick(matrix->num_rows()), *result);
+				matrix = result;
+			}
+			return matrix;
+		}
+	private:
+		std::mt19937 random_;
+		int steps_;
+		std::vector<MatrixPtr> reps_;
+		qvmove::MoveExpander expander_;
+
+		std::size_t pick(std::size_t size) {
+			return std::uniform_int_distribution<std::size_t>(0, size - 1)(random_);
+		}
+};
+
+/** Get the sorted canonical keys of all matrices given by the loader. */
+template<class Loader>
+Keys class_keys(Loader& loader) {
+	Keys keys;
+	while(loader.has_next()) {
+		keys.push_back(qvmove::CanonicalForm::key(*loader.next()));
+	}
+	std::sort(keys.begin(), keys.end());
+	return keys;
+}
+
+/**
+ * Check that the path to the last matrix returned by the search, as written by
+ * qvmove -p, is made of real steps and has the depth the search reported.
+ */
+bool valid_path(const qvmove::MoveSearch& search,
+		const qvmove::MoveExpander& expander) {
+	MatrixPtr matrix = search.matrix(0);
+	qvmove::MoveSearch::Depth depth;
+	for(auto& edge : search.path(search.index())) {
+		const MatrixPtr& child = search.matrix(edge.child_);
+		bool step = false;
+		expander(*matrix, [&](const MatrixPtr& m, int move) {
+				step = step || (move == edge.move_ && std::equal_to<MatrixPtr>()(m, child));
+			});
+		if(!step) {
+			return false;
+		}
+		if(edge.move_ == qvmove::MoveExpander::SinkSource) {
+			++depth.sinksource_;
+		} else {
+			++depth.moves_;
+		}
+		matrix = child;
+	}
+	return depth.moves_ == search.depth().moves_
+		&& depth.sinksource_ == search.depth().sinksource_;
+}
+
+/** Create an empty temporary file, returning its name or "" on failure. */
+std::string temp_file() {
+	const char* dir = std::getenv("TMPDIR");
+	std::string path = std::string(dir ? dir : "/tmp") + "/qvmovediff.XXXXXX";
+	int fd = mkstemp(&path[0]);
+	if(fd == -1) {
+		return "";
+	}
+	close(fd);
+	return path;
+}
+
+/** Write the sorted keys to a class file. */
+bool write_keys(const std::string& path, const Keys& keys) {
+	qvmove::ClassWriter writer(path);
+	for(auto& key : keys) {
+		writer.add(key);
+	}
+	return writer.close();
+}
+
+/** Read back all keys in a class file, or nothing if it cannot be read. */
+Keys read_keys(const std::string& path) {
+	Keys keys;
+	qvmove::ClassReader reader(path);
+	while(reader.is_open() && reader.has_next()) {
+		keys.push_back(reader.next());
+	}
+	return keys;
+}
+
+/**
+ * Write the two sets of keys to class files and check that reading them back,
+ * looking up each key of b in a and merging the files all agree with the same
+ * operations on the sets themselves. Uses the three given files. Returns a
+ * description of the first difference, or "" if there is none.
+ */
+std::string check_class_files(const Keys& a, const Keys& b,
+		const std::string (&files)[3]) {
+	if(!write_keys(files[0], a) || !write_keys(files[1], b)) {
+		return "could not write class files";
+	}
+	if(read_keys(files[0]) != a || read_keys(files[1]) != b) {
+		return "class files read back differently";
+	}
+	qvmove::ClassReader first(files[0]);
+	for(auto& key : b) {
+		if(first.contains(key) != std::binary_search(a.begin(), a.end(), key)) {
+			return "contains gave the wrong answer";
+		}
+	}
+	typedef qvmove::class_file::Operation Operation;
+	for(Operation operation : { Operation::Union, Operation::Intersect,
+			Operation::Difference }) {
+		Keys expected;
+		auto out = std::back_inserter(expected);
+		switch(operation) {
+			case Operation::Union:
+				std::set_union(a.begin(), a.end(), b.begin(), b.end(), out);
+				break;
+			case Operation::Intersect:
+				std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), out);
+				break;
+			case Operation::Difference:
+				std::set_difference(a.begin(), a.end(), b.begin(), b.end(), out);
+				break;
+		}
+		qvmove::ClassReader left(files[0]);
+		qvmove::ClassReader right(files[1]);
+		qvmove::ClassWriter writer(files[2]);
+		qvmove::class_file::merge({ &left, &right }, operation, writer);
+		if(!writer.close() || read_keys(files[2]) != expected) {
+			return "merged class file differs";
+		}
+	}
+	return "";
+}
+
+/**
+ * Run a Checker over the input with the given options, returning the lines it
+ * writes other than the steps of any paths.
+ */
+std::vector<std::string> run_checker(const std::string& input,
+		const qvmove::Checker::Options& options,
+		const std::shared_ptr<qvmove::SharedIndex>& index = nullptr) {
+	auto in = std::make_shared<std::istringstream>(input);
+	auto out = std::make_shared<std::ostringstream>();
+	{
+		qvmove::Checker checker(in, out, qvmove::consts::Moves,
+				qvmove::consts::Reps, qvmove::consts::Graphs, index, options);
+		checker.run();
+	}
+	std::vector<std::string> lines;
+	std::istringstream output(out->str());
+	std::string line;
+	while(std::getline(output, line)) {
+		if(line.empty() || line[0] != '\t') {
+			lines.push_back(line);
+		}
+	}
+	return lines;
+}
+}
+
+void usage() {
+	std::cout << "qvmovediff [-n count] [-r seed] [-k steps] [-t threads] "
+		"[-b budget]" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+	long count = 100;
+	unsigned seed = std::random_device()();
+	int steps = 20;
+	int threads = 4;
+	std::size_t budget = 1 << 16;
+	int c;
+	while ((c = getopt (argc, argv, "n:r:k:t:b:")) != -1) {
+		switch (c){
+			case 'n':
+				count = std::atol(optarg);
+				break;
+			case 'r':
+				seed = std::strtoul(optarg, nullptr, 10);
+				break;
+			case 'k':
+				steps = std::atoi(optarg);
+				break;
+			case 't':
+				threads = std::atoi(optarg);
+				break;
+			case 'b':
+				budget = std::strtoul(optarg, nullptr, 10);
+				break;
+			case '?':
+				usage();
+				return 1;
+			default:
+				usage();
+				return 2;
+		}
+	}
+	Generator generate(seed, steps);
+	if(generate.empty()) {
+		std::cerr << "No representatives with " << MinSize << " to " << MaxSize
+			<< " rows" << std::endl;
+		return 2;
+	}
+	std::cout << "Seed: " << seed << std::endl;
+
+	auto& moves = qvmove::consts::Moves;
+	qvmove::MoveExpander expander(moves);
+	qvmove::TargetSet targets(qvmove::consts::Reps, qvmove::consts::Graphs);
+	/* The built in targets usually have no graphs, so also search for the
+	 * underlying graphs of some other random quivers. */
+	GraphSet graphs(qvmove::consts::Graphs);
+	Generator graph_source(seed + 1, steps);
+	for(int i = 0; i < GraphTargets; ++i) {
+		graphs.insert(std::make_shared<Graph>(*graph_source()));
+	}
+	qvmove::TargetSet graph_targets(qvmove::consts::Reps, graphs);
+	/* As in Checker, the distance estimates only know about representatives. */
+	static const MatrixSet none;
+	qvmove::RepDistance distance(qvmove::consts::Graphs.empty()
+			? qvmove::consts::Reps : none, qvmove::consts::MoveWeightChange);
+	qvmove::RepDistance graph_distance(none,
+			qvmove::consts::MoveWeightChange);
+	qvmove::WorkPool pool(threads);
+	static const GraphSet no_graphs;
+	qvmove::TargetSet nothing(none, no_graphs);
+	qvmove::ParallelSearch parallel_class(pool, moves, nothing);
+	std::string files[3] = { temp_file(), temp_file(), temp_file() };
+	if(files[0].empty() || files[1].empty() || files[2].empty()) {
+		std::cerr << "Error creating temporary files" << std::endl;
+		return 2;
+	}
+
+	Tally tally;
+	auto check = [&](const std::string& name, const std::string& reference,
+			const MatrixPtr& m, const qvmove::Result& ref,
+			const std::function<qvmove::Result()>& f) {
+		tally.start(name, reference);
+		qvmove::Result result = f();
+		tally.stop(name);
+		if(!agrees(ref, result)) {
+			tally.fail(name);
+			std::cout << name << ": expected " << ref << " got " << result << ": "
+				<< *m << std::endl;
+		}
+	};
+	auto check_class = [&](const std::string& name, const MatrixPtr& m,
+			const Keys& ref, const std::function<Keys()>& f) {
+		tally.start(name, "class");
+		Keys keys = f();
+		tally.stop(name);
+		if(keys != ref) {
+			tally.fail(name);
+			std::cout << name << ": expected " << ref.size() << " matrices got "
+				<< keys.size() << ": " << *m << std::endl;
+		}
+	};
+	/* Run every engine with the given targets, naming each with the suffix. */
+	auto check_engines = [&](const std::string& suffix, const MatrixPtr& m,
+			const qvmove::TargetSet& goals, const qvmove::RepDistance& guide) {
+		std::string loader_name = "loader" + suffix;
+		qvmove::Result ref;
+		tally.start(loader_name);
+		cluster::MoveClassLoader loader(m, moves);
+		while(loader.has_next()) {
+			if(goals(loader.next())) {
+				ref = qvmove::Result(loader.depth().moves_, loader.depth().sinksource_);
+				break;
+			}
+		}
+		tally.stop(loader_name);
+		check("search" + suffix, loader_name, m, ref, [&]() {
+				qvmove::MoveSearch search(m, moves);
+				while(search.has_next()) {
+					if(goals(search.next())) {
+						return qvmove::Result(search.depth().moves_,
+								search.depth().sinksource_);
+					}
+				}
+				return qvmove::Result();
+			});
+		check("parallel" + suffix, loader_name, m, ref, [&]() {
+				return qvmove::ParallelSearch(pool, moves, goals).run(m);
+			});
+		check("exact" + suffix, loader_name, m, ref, [&]() {
+				return qvmove::BestFirstSearch(moves, goals, guide, true).run(m);
+			});
+		check("guided" + suffix, loader_name, m, ref, [&]() {
+				return qvmove::BestFirstSearch(moves, goals, guide, false).run(m);
+			});
+		check("bounded" + suffix, loader_name, m, ref, [&]() {
+				return qvmove::BoundedSearch(moves, goals, budget).run(m);
+			});
+		return ref;
+	};
+
+	/* Result of the plain search for a matrix. */
+	auto reference = [&](const MatrixPtr& m) {
+		cluster::MoveClassLoader loader(m, moves);
+		while(loader.has_next()) {
+			if(targets(loader.next())) {
+				return qvmove::Result(loader.depth().moves_,
+						loader.depth().sinksource_);
+			}
+		}
+		return qvmove::Result();
+	};
+	/* The line qvmove writes for a result. */
+	auto line = [](const qvmove::Result& result, const MatrixPtr& m) {
+		std::ostringstream out;
+		out << result << ": " << *m;
+		return out.str();
+	};
+	typedef std::vector<std::string> Lines;
+	std::ostringstream input;
+	/* Expected output of qvmove for each input, and of qvmove -d or -c, which
+	 * search from the canonical labelling of each input. */
+	Lines plain_lines;
+	Lines shared_lines;
+	Keys last_class;
+	for(long i = 0; i < count; ++i) {
+		MatrixPtr m = generate();
+		qvmove::Result ref = check_engines("", m, targets, distance);
+		input << *m << std::endl;
+		plain_lines.push_back(line(ref, m));
+		std::string key = qvmove::CanonicalForm::key(*m);
+		if(key.empty()) {
+			shared_lines.push_back(plain_lines.back());
+		} else {
+			/* Add relabelled copies of some quivers, which must get the same result
+			 * as the originals when results are shared. */
+			MatrixPtr relabelled = qvmove::CanonicalForm::matrix(key);
+			qvmove::Result shared = reference(relabelled);
+			shared_lines.push_back(line(shared, m));
+			if(i % 3 == 0) {
+				input << *relabelled << std::endl;
+				plain_lines.push_back(line(shared, relabelled));
+				shared_lines.push_back(plain_lines.back());
+			}
+		}
+
+		check_engines("-g", m, graph_targets, graph_distance);
+		bool valid = true;
+		check("path", "loader", m, ref, [&]() {
+				qvmove::MoveSearch search(m, moves);
+				while(search.has_next()) {
+					if(targets(search.next())) {
+						valid = valid_path(search, expander);
+						return qvmove::Result(search.depth().moves_,
+								search.depth().sinksource_);
+					}
+				}
+				return qvmove::Result();
+			});
+		if(!valid) {
+			tally.fail("path");
+			std::cout << "path: invalid step: " << *m << std::endl;
+		}
+
+		Keys ref_class;
+		tally.start("class");
+		cluster::MoveClassLoader class_loader(m, moves);
+		ref_class = class_keys(class_loader);
+		tally.stop("class");
+		check_class("search-cl", m, ref_class, [&]() {
+				qvmove::MoveSearch search(m, moves);
+				return class_keys(search);
+			});
+		check_class("parallel-cl", m, ref_class, [&]() {
+				Keys keys;
+				parallel_class.enumerate(m, [&keys](const MatrixPtr& matrix) {
+						keys.push_back(qvmove::CanonicalForm::key(*matrix));
+						return true;
+					});
+				std::sort(keys.begin(), keys.end());
+				return keys;
+			});
+		/* Compare the class with half of itself and the previous class, so that
+		 * every set operation has something to keep and something to drop. */
+		Keys other = last_class;
+		for(std::size_t j = 0; j < ref_class.size(); j += 2) {
+			other.push_back(ref_class[j]);
+		}
+		std::sort(other.begin(), other.end());
+		other.erase(std::unique(other.begin(), other.end()), other.end());
+		tally.start("class-file");
+		std::string error = check_class_files(ref_class, other, files);
+		tally.stop("class-file");
+		if(!error.empty()) {
+			tally.fail("class-file");
+			std::cout << "class-file: " << error << ": " << *m << std::endl;
+		}
+		last_class.swap(ref_class);
+	}
+	for(auto& file : files) {
+		std::remove(file.c_str());
+	}
+
+	/* Every way of running qvmove must give the results of the plain search,
+	 * for the canonical labelling of each input if results are shared. */
+	typedef qvmove::Checker::Options Options;
+	auto check_checker = [&](const std::string& name, const Lines& expected,
+			const std::function<Lines()>& f) {
+		tally.start(name, "checker");
+		Lines lines = f();
+		tally.stop(name);
+		for(std::size_t j = 0; j < std::min(lines.size(), expected.size()); ++j) {
+			if(lines[j] != expected[j]) {
+				tally.fail(name);
+				std::cout << name << ": expected \"" << expected[j] << "\" got \""
+					<< lines[j] << "\"" << std::endl;
+			}
+		}
+		if(lines.size() != expected.size()) {
+			tally.fail(name);
+			std::cout << name << ": expected " << expected.size() << " lines got "
+				<< lines.size() << std::endl;
+		}
+	};
+	Options plain;
+	plain.per_move_ = qvmove::consts::MoveWeightChange;
+	check_checker("checker", plain_lines, [&]() {
+			return run_checker(input.str(), plain);
+		});
+	Options parallel = plain;
+	parallel.threads_ = threads;
+	check_checker("threads", plain_lines, [&]() {
+			return run_checker(input.str(), parallel);
+		});
+	Options paths = plain;
+	paths.paths_ = true;
+	check_checker("paths", plain_lines, [&]() {
+			return run_checker(input.str(), paths);
+		});
+	Options dedupe = plain;
+	dedupe.dedupe_ = 4;
+	check_checker("dedupe", shared_lines, [&]() {
+			return run_checker(input.str(), dedupe);
+		});
+	parallel.dedupe_ = 4;
+	check_checker("threads-dedupe", shared_lines, [&]() {
+			return run_checker(input.str(), parallel);
+		});
+	std::string index_file = temp_file();
+	if(index_file.empty()) {
+		std::cerr << "Error creating temporary files" << std::endl;
+		return 2;
+	}
+	{
+		/* The first run fills the index and the second reads it back. */
+		auto index = std::make_shared<qvmove::SharedIndex>(index_file, 0,
+				4 * static_cast<std::uint64_t>(plain_lines.size()) + 64);
+		if(!index->is_open()) {
+			std::cerr << "Error opening index " << index_file << std::endl;
+			std::remove(index_file.c_str());
+			return 2;
+		}
+		check_checker("index", shared_lines, [&]() {
+				return run_checker(input.str(), plain, index);
+			});
+		check_checker("index-read", shared_lines, [&]() {
+				return run_checker(input.str(), parallel, index);
+			});
+	}
+	std::remove(index_file.c_str());
+
+	tally.write(std::cout);
+	return tally.failures() > 0 ? 3 : 0;
+}
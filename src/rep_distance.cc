@@ -0,0 +1,88 @@
+/**
+ * rep_distance.cc
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "rep_distance.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+namespace qvmove {
+
+RepDistance::RepDistance(const MatrixSet& reps, int per_move)
+	: reps_(),
+		per_move_(std::max(1, per_move)) {
+	for(auto& rep : reps) {
+		reps_[rep->num_rows()].push_back(invariants(*rep));
+	}
+}
+int RepDistance::lower_bound(const Matrix& m) const {
+	auto it = reps_.find(m.num_rows());
+	if(it == reps_.end()) {
+		return 0;
+	}
+	Invariants inv = invariants(m);
+	int best = INT_MAX;
+	for(auto& rep : it->second) {
+		best = std::min(best, weight_diff(inv, rep));
+	}
+	return (best + per_move_ - 1) / per_move_;
+}
+int RepDistance::estimate(const Matrix& m) const {
+	auto it = reps_.find(m.num_rows());
+	if(it == reps_.end()) {
+		return 0;
+	}
+	Invariants inv = invariants(m);
+	int best = INT_MAX;
+	for(auto& rep : it->second) {
+		best = std::min(best, weight_diff(inv, rep) + degree_diff(inv, rep));
+	}
+	return best;
+}
+RepDistance::Invariants RepDistance::invariants(const Matrix& m) {
+	int size = m.num_rows();
+	Invariants result = { std::vector<int>(MaxWeight + 1, 0),
+		std::vector<int>(size, 0) };
+	for(int r = 0; r < size; ++r) {
+		for(int c = r + 1; c < size; ++c) {
+			int w = std::abs(m.get(r, c));
+			if(w != 0) {
+				++result.weights_[std::min(w, MaxWeight)];
+				++result.degrees_[r];
+				++result.degrees_[c];
+			}
+		}
+	}
+	std::sort(result.degrees_.begin(), result.degrees_.end());
+	return result;
+}
+int RepDistance::weight_diff(const Invariants& a, const Invariants& b) {
+	int result = 0;
+	for(int w = 1; w <= MaxWeight; ++w) {
+		result += std::abs(a.weights_[w] - b.weights_[w]);
+	}
+	return result;
+}
+int RepDistance::degree_diff(const Invariants& a, const Invariants& b) {
+	int result = 0;
+	for(std::size_t i = 0; i < a.degrees_.size(); ++i) {
+		result += std::abs(a.degrees_[i] - b.degrees_[i]);
+	}
+	return result;
+}
+
+}
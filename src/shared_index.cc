@@ -0,0 +1,185 @@
+/**
+ * shared_index.cc
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * The index file consists of a Header followed by a fixed number of Slots,
+ * used as an open addressing hash table with linear probing. The hash used is
+ * that of the EquivQuiverMatrix, so all permutations of a matrix probe the same
+ * slots.
+ *
+ * Each slot is claimed by atomically changing its state from Empty to Writing,
+ * filled in, and then marked Ready. Readers ignore any slot which is not Ready,
+ * so can never see a half written entry. Slots are never removed, so a reader
+ * can stop probing as soon as it finds an Empty slot.
+ */
+#include "shared_index.h"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace qvmove {
+namespace {
+	/* "QVMVIDX1" */
+	const std::uint64_t Magic = 0x31584449564d5651ULL;
+}
+
+SharedIndex::SharedIndex(const std::string& path, std::uint64_t key,
+		std::uint64_t capacity)
+	: fd_(-1),
+		map_(MAP_FAILED),
+		length_(0),
+		header_(nullptr),
+		slots_(nullptr) {
+	fd_ = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+	if(fd_ == -1) {
+		return;
+	}
+	/* The lock is only held while the file is created or checked, never while
+	 * the table is in use. */
+	if(flock(fd_, LOCK_EX) == -1) {
+		close(fd_);
+		fd_ = -1;
+		return;
+	}
+	struct stat st;
+	bool ok = fstat(fd_, &st) == 0;
+	if(ok && st.st_size == 0) {
+		Header header = { Magic, Version, key, capacity };
+		ok = ftruncate(fd_, sizeof(Header) + capacity * sizeof(Slot)) == 0
+			&& pwrite(fd_, &header, sizeof(Header), 0) == sizeof(Header);
+	}
+	Header header;
+	ok = ok && pread(fd_, &header, sizeof(Header), 0) == sizeof(Header)
+		&& header.magic_ == Magic && header.version_ == Version
+		&& header.key_ == key;
+	if(ok) {
+		length_ = sizeof(Header) + header.capacity_ * sizeof(Slot);
+		ok = fstat(fd_, &st) == 0
+			&& static_cast<std::size_t>(st.st_size) >= length_;
+	}
+	flock(fd_, LOCK_UN);
+	if(ok) {
+		map_ = mmap(nullptr, length_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+	}
+	if(map_ == MAP_FAILED) {
+		close(fd_);
+		fd_ = -1;
+		return;
+	}
+	header_ = static_cast<Header*>(map_);
+	slots_ = reinterpret_cast<Slot*>(static_cast<char*>(map_) + sizeof(Header));
+}
+SharedIndex::~SharedIndex() {
+	if(map_ != MAP_FAILED) {
+		munmap(map_, length_);
+	}
+	if(fd_ != -1) {
+		close(fd_);
+	}
+}
+bool SharedIndex::is_open() const {
+	return slots_ != nullptr;
+}
+bool SharedIndex::find(const Matrix& m, Result& result) const {
+	if(!storable(m)) {
+		return false;
+	}
+	std::size_t hash = m.hash();
+	std::uint64_t capacity = header_->capacity_;
+	for(std::uint64_t i = 0; i < MaxProbes && i < capacity; ++i) {
+		const Slot& slot = slots_[(hash + i) % capacity];
+		std::uint32_t state = slot.state_.load(std::memory_order_acquire);
+		if(state == Empty) {
+			return false;
+		}
+		if(state == Ready && matches(slot, static_cast<std::uint32_t>(hash), m)) {
+			result.found_ = slot.found_ != 0;
+			result.moves_ = slot.moves_;
+			result.sinksource_ = slot.sinksource_;
+			return true;
+		}
+	}
+	return false;
+}
+bool SharedIndex::insert(const Matrix& m, const Result& result) {
+	if(!storable(m)) {
+		return false;
+	}
+	std::size_t hash = m.hash();
+	std::uint64_t capacity = header_->capacity_;
+	for(std::uint64_t i = 0; i < MaxProbes && i < capacity; ++i) {
+		Slot& slot = slots_[(hash + i) % capacity];
+		std::uint32_t state = Empty;
+		if(slot.state_.compare_exchange_strong(state, Writing,
+					std::memory_order_acq_rel)) {
+			int size = m.num_rows();
+			slot.hash_ = static_cast<std::uint32_t>(hash);
+			slot.moves_ = result.moves_;
+			slot.sinksource_ = result.sinksource_;
+			slot.found_ = result.found_ ? 1 : 0;
+			slot.size_ = static_cast<std::int8_t>(size);
+			int k = 0;
+			for(int r = 0; r < size; ++r) {
+				for(int c = r + 1; c < size; ++c) {
+					slot.entries_[k++] = static_cast<std::int8_t>(m.get(r, c));
+				}
+			}
+			slot.state_.store(Ready, std::memory_order_release);
+			return true;
+		}
+		/* On failure state now holds the slot's current state. */
+		if(state == Ready && matches(slot, static_cast<std::uint32_t>(hash), m)) {
+			return true;
+		}
+	}
+	return false;
+}
+bool SharedIndex::matches(const Slot& slot, std::uint32_t hash,
+		const Matrix& m) const {
+	int size = m.num_rows();
+	if(slot.hash_ != hash || slot.size_ != size) {
+		return false;
+	}
+	Matrix stored(size, size);
+	int k = 0;
+	for(int r = 0; r < size; ++r) {
+		for(int c = r + 1; c < size; ++c) {
+			stored.set(r, c, slot.entries_[k]);
+			stored.set(c, r, -slot.entries_[k]);
+			++k;
+		}
+	}
+	return stored.equals(m);
+}
+bool SharedIndex::storable(const Matrix& m) {
+	int size = m.num_rows();
+	if(size > MaxSize || size != m.num_cols()) {
+		return false;
+	}
+	for(int r = 0; r < size; ++r) {
+		for(int c = r + 1; c < size; ++c) {
+			int v = m.get(r, c);
+			if(v > 127 || v < -127) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+}
@@ -0,0 +1,96 @@
+/**
+ * target_set.cc
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "target_set.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace qvmove {
+
+TargetSet::TargetSet(const MatrixSet& reps, const GraphSet& graphs)
+	: reps_(reps),
+		graphs_(graphs),
+		graph_invariants_(),
+		filter_(true) {
+	for(auto& graph : graphs_) {
+		MatrixPtr m = quiver(*graph);
+		if(!m) {
+			filter_ = false;
+			graph_invariants_.clear();
+			break;
+		}
+		graph_invariants_.insert(invariants(*m));
+	}
+}
+
+bool TargetSet::operator()(const MatrixPtr& matrix) const {
+	if(reps_.find(matrix) != reps_.end()) {
+		return true;
+	}
+	if(graphs_.empty() || (filter_ &&
+			graph_invariants_.find(invariants(*matrix)) == graph_invariants_.end())) {
+		return false;
+	}
+	GraphPtr graph = std::make_shared<Graph>(*matrix);
+	return graphs_.find(graph) != graphs_.end();
+}
+TargetSet::Invariants TargetSet::invariants(const cluster::IntMatrix& m) {
+	int size = m.num_rows();
+	Invariants result(size + 2, 0);
+	result[0] = size;
+	for(int r = 0; r < size; ++r) {
+		for(int c = r + 1; c < size; ++c) {
+			if(m.get(r, c) != 0) {
+				++result[1];
+				++result[r + 2];
+				++result[c + 2];
+			}
+		}
+	}
+	std::sort(result.begin() + 2, result.end());
+	return result;
+}
+TargetSet::MatrixPtr TargetSet::quiver(const Graph& graph) {
+	/* Try orienting each edge of the graph's own matrix from lower to higher
+	 * vertex, and only trust the result if it gives back the same graph. */
+	int size = graph.num_rows();
+	if(size != graph.num_cols()) {
+		return MatrixPtr();
+	}
+	MatrixPtr result = std::make_shared<Matrix>(size, size);
+	for(int r = 0; r < size; ++r) {
+		for(int c = r + 1; c < size; ++c) {
+			int v = std::abs(graph.get(r, c));
+			result->set(r, c, v);
+			result->set(c, r, -v);
+		}
+	}
+	if(!Graph(*result).equals(graph)) {
+		return MatrixPtr();
+	}
+	return result;
+}
+std::size_t TargetSet::InvariantsHash::operator()(
+		const Invariants& inv) const {
+	std::size_t result = 0;
+	for(int i : inv) {
+		result = result * 31 + i;
+	}
+	return result;
+}
+
+}
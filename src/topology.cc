@@ -0,0 +1,86 @@
+/**
+ * topology.cc
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "topology.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace qvmove {
+
+Topology::Topology()
+	: cpus_() {
+	for(int node = 0; ; ++node) {
+		std::ifstream file("/sys/devices/system/node/node"
+				+ std::to_string(node) + "/cpulist");
+		std::string list;
+		if(!file.is_open() || !std::getline(file, list)) {
+			break;
+		}
+		std::vector<int> cpus = parse_list(list);
+		/* Nodes with memory but no CPUs cannot run any workers. */
+		if(!cpus.empty()) {
+			cpus_.push_back(cpus);
+		}
+	}
+	if(cpus_.empty()) {
+		int n = std::max(1u, std::thread::hardware_concurrency());
+		cpus_.emplace_back();
+		for(int i = 0; i < n; ++i) {
+			cpus_[0].push_back(i);
+		}
+	}
+}
+int Topology::nodes() const {
+	return static_cast<int>(cpus_.size());
+}
+const std::vector<int>& Topology::cpus(int node) const {
+	return cpus_[node];
+}
+bool Topology::bind(int node) const {
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for(int cpu : cpus_[node]) {
+		CPU_SET(cpu, &set);
+	}
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+std::vector<int> Topology::parse_list(const std::string& list) {
+	std::vector<int> result;
+	std::stringstream ss(list);
+	std::string range;
+	while(std::getline(ss, range, ',')) {
+		if(range.empty()) {
+			continue;
+		}
+		std::size_t dash = range.find('-');
+		int first = std::atoi(range.c_str());
+		int last = dash == std::string::npos ? first
+			: std::atoi(range.c_str() + dash + 1);
+		for(int cpu = first; cpu <= last; ++cpu) {
+			result.push_back(cpu);
+		}
+	}
+	return result;
+}
+
+}
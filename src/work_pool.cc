@@ -0,0 +1,208 @@
+/**
+ * work_pool.cc
+ * Copyright 2014-2015 John Lawson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "work_pool.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace qvmove {
+namespace {
+	/* The pool and queue which belong to the current thread, if any. */
+	thread_local const WorkPool* current_pool = nullptr;
+	thread_local int current_queue = -1;
+}
+
+WorkPool::WorkPool(int threads)
+	: topology_(),
+		queues_(),
+		node_of_(),
+		workers_on_(),
+		steal_order_(),
+		threads_(),
+		sleep_mutex_(),
+		wake_(),
+		queued_(0),
+		pinned_(),
+		next_queue_(0),
+		stop_(false) {
+	/* More nodes than threads would leave some nodes without workers. */
+	int nodes = std::max(1, std::min(topology_.nodes(), threads));
+	workers_on_.resize(nodes);
+	pinned_.reset(new std::atomic<long>[nodes]);
+	for(int i = 0; i < nodes; ++i) {
+		pinned_[i] = 0;
+	}
+	for(int i = 0; i < threads; ++i) {
+		queues_.emplace_back(new Queue());
+		node_of_.push_back(i * nodes / threads);
+		workers_on_[node_of_[i]].push_back(i);
+	}
+	for(int i = 0; i < threads; ++i) {
+		steal_order_.emplace_back();
+		for(int j = 1; j < threads; ++j) {
+			int other = (i + j) % threads;
+			if(node_of_[other] == node_of_[i]) {
+				steal_order_[i].push_back(other);
+			}
+		}
+		for(int j = 1; j < threads; ++j) {
+			int other = (i + j) % threads;
+			if(node_of_[other] != node_of_[i]) {
+				steal_order_[i].push_back(other);
+			}
+		}
+	}
+	for(int i = 0; i < threads; ++i) {
+		threads_.emplace_back(&WorkPool::work, this, i);
+	}
+}
+WorkPool::~WorkPool() {
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex_);
+		stop_ = true;
+	}
+	wake_.notify_all();
+	for(auto& thread : threads_) {
+		thread.join();
+	}
+}
+void WorkPool::submit(Group& group, Task task) {
+	group.pending_.fetch_add(1, std::memory_order_relaxed);
+	int queue = self();
+	if(queue < 0) {
+		queue = next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+	}
+	push(queue, { &group, std::move(task), -1 });
+}
+void WorkPool::submit(Group& group, Task task, int node, bool pinned) {
+	group.pending_.fetch_add(1, std::memory_order_relaxed);
+	node %= nodes();
+	int queue = self();
+	if(queue < 0 || node_of_[queue] != node) {
+		const std::vector<int>& workers = workers_on_[node];
+		queue = workers[next_queue_.fetch_add(1, std::memory_order_relaxed)
+			% workers.size()];
+	}
+	/* With a single node every worker is local, and pinning would only stop
+	 * waiting threads outside the pool from helping. */
+	push(queue, { &group, std::move(task), pinned && nodes() > 1 ? node : -1 });
+}
+void WorkPool::push(int queue, Item item) {
+	int node = item.node_;
+	{
+		std::lock_guard<std::mutex> lock(queues_[queue]->mutex_);
+		queues_[queue]->items_.push_front(std::move(item));
+	}
+	(node < 0 ? queued_ : pinned_[node]).fetch_add(1, std::memory_order_release);
+	{
+		/* Ensure a worker about to sleep sees the new task. */
+		std::lock_guard<std::mutex> lock(sleep_mutex_);
+	}
+	if(node < 0) {
+		wake_.notify_one();
+	} else {
+		/* Only some workers can run the task, and they may not be the first to
+		 * wake. */
+		wake_.notify_all();
+	}
+}
+void WorkPool::wait(Group& group) {
+	int me = self();
+	while(!group.done()) {
+		if(!run_one(me)) {
+			std::unique_lock<std::mutex> lock(sleep_mutex_);
+			wake_.wait(lock, [&]() {
+					return group.done() || runnable(me);
+				});
+		}
+	}
+}
+int WorkPool::size() const {
+	return static_cast<int>(queues_.size());
+}
+int WorkPool::nodes() const {
+	return static_cast<int>(workers_on_.size());
+}
+int WorkPool::self() const {
+	return current_pool == this ? current_queue : -1;
+}
+bool WorkPool::runnable(int self) const {
+	return queued_.load(std::memory_order_acquire) > 0 || (self >= 0
+			&& pinned_[node_of_[self]].load(std::memory_order_acquire) > 0);
+}
+bool WorkPool::allowed(int self, const Item& item) const {
+	return item.node_ < 0 || (self >= 0 && item.node_ == node_of_[self]);
+}
+bool WorkPool::run_one(int self) {
+	Item item = { nullptr, Task(), -1 };
+	int size = static_cast<int>(queues_.size());
+	if(self >= 0) {
+		std::lock_guard<std::mutex> lock(queues_[self]->mutex_);
+		if(!queues_[self]->items_.empty()) {
+			item = std::move(queues_[self]->items_.front());
+			queues_[self]->items_.pop_front();
+		}
+	}
+	/* Steal the oldest task we are allowed to run from the first other queue
+	 * which has one, trying workers on the same node first. A worker's own queue
+	 * only holds tasks pinned to its own node. */
+	int others = self >= 0 ? static_cast<int>(steal_order_[self].size()) : size;
+	for(int i = 0; item.group_ == nullptr && i < others; ++i) {
+		Queue& queue = *queues_[self >= 0 ? steal_order_[self][i] : i];
+		std::lock_guard<std::mutex> lock(queue.mutex_);
+		for(auto it = queue.items_.rbegin(); it != queue.items_.rend(); ++it) {
+			if(allowed(self, *it)) {
+				item = std::move(*it);
+				queue.items_.erase(std::next(it).base());
+				break;
+			}
+		}
+	}
+	if(item.group_ == nullptr) {
+		return false;
+	}
+	(item.node_ < 0 ? queued_ : pinned_[item.node_])
+		.fetch_sub(1, std::memory_order_relaxed);
+	item.task_();
+	if(item.group_->pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		{
+			std::lock_guard<std::mutex> lock(sleep_mutex_);
+		}
+		wake_.notify_all();
+	}
+	return true;
+}
+void WorkPool::work(int self) {
+	current_pool = this;
+	current_queue = self;
+	if(nodes() > 1) {
+		topology_.bind(node_of_[self]);
+	}
+	for(;;) {
+		if(!run_one(self)) {
+			std::unique_lock<std::mutex> lock(sleep_mutex_);
+			wake_.wait(lock, [&]() {
+					return stop_ || runnable(self);
+				});
+			if(stop_ && !runnable(self)) {
+				return;
+			}
+		}
+	}
+}
+
+}